@@ -0,0 +1,335 @@
+// Benchmark del gestor de procesos (main.cpp): mide las operaciones de
+// fondo que usan los mens y el modo script (crearProceso, borrarProceso,
+// encolarProceso, ejecutarSiguiente, reservarMemoria, liberarTope), las
+// mismas operaciones en el motor SoA, la cola por niveles, el asignador buddy,
+// la bitcora (--wal) y el registro de procesos partido en fragmentos, con
+// varios hilos.
+//
+// Compilar y correr en Linux:  make -C benchmark run
+
+#define SIN_MAIN
+#include "../main.cpp"
+#include "medicion.h"
+
+// Nombres compartidos por los procesos, como en una carga real
+const int CANT_NOMBRES = 64;
+string nombresBench[CANT_NOMBRES];
+
+void prepararNombres() {
+    for (int i = 0; i < CANT_NOMBRES; i++) {
+        char texto[32];
+        snprintf(texto, sizeof(texto), "proceso_de_prueba_%d", i);
+        nombresBench[i] = texto;
+    }
+}
+
+// A qu proceso (ndice en pids) va cada bloque de memoria: uniforme,
+// 90% de los bloques en el 1% de los procesos, o todos en uno solo
+// (la cadena de ese proceso crece hasta n)
+vector<int> generarDuenosBloques(int n, int dist, Generador& g) {
+    vector<int> duenos(n);
+    int calientes = n / 100 > 0 ? n / 100 : 1;
+    for (int i = 0; i < n; i++) {
+        if (dist == DIST_UNIFORME) duenos[i] = (int)g.rango(n);
+        else if (dist == DIST_SESGADA) duenos[i] = g.rango(10) != 0 ? (int)g.rango(calientes) : (int)g.rango(n);
+        else duenos[i] = n - 1;
+    }
+    return duenos;
+}
+
+// Orden de las bsquedas y los borrados: una permutacin aleatoria
+vector<int> generarOrden(int n, Generador& g) {
+    vector<int> orden(n);
+    for (int i = 0; i < n; i++) orden[i] = i;
+    mezclar(orden, g);
+    return orden;
+}
+
+// Secuencia comn a los dos motores: se deja la mitad de los procesos en
+// la cola y la mitad de los bloques en la pila para que el borrado final
+// recorra tambin esos caminos. Los bloques miden de 1 a 4 KB, as que con
+// el pool buddy alcanzan 4n KB. Si prioridadMaxima > 0, las prioridades se
+// pliegan a 1..prioridadMaxima (la adversaria sigue siendo decreciente por tramos).
+void correrListas(const char* estructura, int n, int dist, Generador& g, Reporte& r,
+                  int prioridadMaxima) {
+    prepararNombres();
+    vector<int> pids = generarPIDs(n, dist, g);
+    vector<int> prioridades = generarPrioridades(n, dist, g);
+    if (prioridadMaxima > 0) {
+        for (int i = 0; i < n; i++) prioridades[i] = 1 + (prioridades[i] - 1) % prioridadMaxima;
+    }
+    vector<int> duenos = generarDuenosBloques(n, dist, g);
+    vector<int> orden = generarOrden(n, g);
+    unsigned long long suma = 0;
+
+    Cronometro c1;
+    for (int i = 0; i < n; i++) suma += crearProceso(pids[i], nombresBench[i % CANT_NOMBRES], prioridades[i]);
+    r.agregar(estructura, "insertar", n, c1.ns());
+
+    Cronometro c2;
+    for (int i = 0; i < n; i++) suma += buscarProcesoPorPID(pids[orden[i]])->prioridad;
+    r.agregar(estructura, "buscar", n, c2.ns());
+
+    Cronometro c3;
+    for (int i = 0; i < n; i++) suma += encolarProceso(pids[i]);
+    r.agregar(estructura, "encolar", n, c3.ns());
+
+    int mitad = n / 2;
+    Cronometro c4;
+    for (int i = 0; i < mitad; i++) suma += ejecutarSiguiente()->pid;
+    r.agregar(estructura, "desencolar", mitad, c4.ns());
+
+    Cronometro c5;
+    for (int i = 0; i < n; i++) suma += reservarMemoria(pids[duenos[i]], 1 + (i & 3));
+    r.agregar(estructura, "asignar_memoria", n, c5.ns());
+
+    Cronometro c6;
+    for (int i = 0; i < mitad; i++) {
+        BloqueMemoria* b = liberarTope();
+        suma += b->tamanio;
+        poolBloques.devolver(b);
+    }
+    r.agregar(estructura, "liberar_memoria", mitad, c6.ns());
+
+    Cronometro c7;
+    for (int i = 0; i < n; i++) suma += borrarProceso(pids[orden[i]], NULL, NULL);
+    r.agregar(estructura, "eliminar", n, c7.ns());
+
+    sumidero = sumidero + suma;
+}
+
+void casoListas(int n, int dist, Generador& g, Reporte& r) {
+    correrListas("listas", n, dist, g, r, 0);
+}
+
+// Mismas prioridades que listas_niveles pero con el montculo, para comparar
+void casoListasAcotadas(int n, int dist, Generador& g, Reporte& r) {
+    correrListas("listas_1024", n, dist, g, r, ColaNiveles::NIVELES);
+}
+
+void casoListasNiveles(int n, int dist, Generador& g, Reporte& r) {
+    planificadorNiveles = true;
+    correrListas("listas_niveles", n, dist, g, r, ColaNiveles::NIVELES);
+}
+
+// Igual que casoListas, pero cada bloque de la pila recibe direcciones del pool buddy
+void casoListasBuddy(int n, int dist, Generador& g, Reporte& r) {
+    memoriaBuddy.iniciar(4 * n);
+    correrListas("listas_buddy", n, dist, g, r, 0);
+}
+
+// Igual que casoListas, anotando cada operacin en la bitcora con
+// confirmacin en grupo cada 10 ms (lo mismo que --wal en el modo script)
+void casoListasBitacora(int n, int dist, Generador& g, Reporte& r) {
+    const char* ruta = "bench_gestor.wal";
+    if (!bitacora.abrir(ruta, 0, nuevaEpoca(), 0, 0)) {
+        fprintf(stderr, "No se pudo crear %s\n", ruta);
+        return;
+    }
+    bitacora.intervaloMs = 10;
+    correrListas("listas_wal", n, dist, g, r, 0);
+    bitacora.cerrar();
+    remove(ruta);
+}
+
+void casoSoA(int n, int dist, Generador& g, Reporte& r) {
+    prepararNombres();
+    vector<int> pids = generarPIDs(n, dist, g);
+    vector<int> prioridades = generarPrioridades(n, dist, g);
+    vector<int> duenos = generarDuenosBloques(n, dist, g);
+    vector<int> orden = generarOrden(n, g);
+    TablaProcesosSoA& t = motorSoA.tabla;
+    unsigned long long suma = 0;
+
+    Cronometro c1;
+    for (int i = 0; i < n; i++) {
+        const string& nombre = nombresBench[i % CANT_NOMBRES];
+        if (t.ranuraDePID(pids[i]) == 0) {
+            suma += t.crear(pids[i], nombre.data(), (unsigned)nombre.size(), prioridades[i]).ranura;
+        }
+    }
+    r.agregar("soa", "insertar", n, c1.ns());
+
+    Cronometro c2;
+    for (int i = 0; i < n; i++) suma += t.prioridadDe(t.ranuraDePID(pids[orden[i]]));
+    r.agregar("soa", "buscar", n, c2.ns());
+
+    Cronometro c3;
+    for (int i = 0; i < n; i++) {
+        unsigned ranura = t.ranuraDePID(pids[i]);
+        if (t.posCola[ranura] < 0) {
+            motorSoA.cola.insertar(t.manejador(ranura));
+            t.fijarEstado(ranura, ESTADO_EN_COLA);
+        }
+    }
+    r.agregar("soa", "encolar", n, c3.ns());
+
+    int mitad = n / 2;
+    Cronometro c4;
+    for (int i = 0; i < mitad; i++) {
+        ManejadorProceso h = motorSoA.cola.extraer();
+        if (t.valido(h)) t.fijarEstado(h.ranura, ESTADO_EJECUTADO);
+        suma += h.ranura;
+    }
+    r.agregar("soa", "desencolar", mitad, c4.ns());
+
+    Cronometro c5;
+    for (int i = 0; i < n; i++) {
+        suma += motorSoA.pila.apilar(t.manejador(t.ranuraDePID(pids[duenos[i]])), 1 + (i & 3));
+    }
+    r.agregar("soa", "asignar_memoria", n, c5.ns());
+
+    Cronometro c6;
+    for (int i = 0; i < mitad; i++) {
+        int b = motorSoA.pila.tope;
+        suma += motorSoA.pila.bloques[b].tamanio;
+        motorSoA.pila.desapilar(b);
+    }
+    r.agregar("soa", "liberar_memoria", mitad, c6.ns());
+
+    Cronometro c7;
+    for (int i = 0; i < n; i++) motorSoA.borrar(t.ranuraDePID(pids[orden[i]]));
+    r.agregar("soa", "eliminar", n, c7.ns());
+
+    sumidero = sumidero + suma;
+}
+
+// El asignador buddy solo: n reservas, n liberaciones y n ciclos de
+// liberar + reservar con el pool a medio llenar.
+// Tamaos: uniforme de 1 a 4 KB; sesgada, casi todos de 1 KB; adversaria,
+// todos de 1 KB y se libera primero uno de cada dos, as ningn bloque
+// libre encuentra a su buddy hasta la segunda mitad.
+void casoBuddy(int n, int dist, Generador& g, Reporte& r) {
+    AsignadorBuddy m;
+    m.iniciar(4 * n);
+    vector<int> tamanios(n);
+    for (int i = 0; i < n; i++) {
+        if (dist == DIST_UNIFORME) tamanios[i] = 1 + (int)g.rango(4);
+        else if (dist == DIST_SESGADA) tamanios[i] = g.rango(10) != 0 ? 1 : 4;
+        else tamanios[i] = 1;
+    }
+    vector<int> orden(n);
+    if (dist == DIST_ADVERSARIA) {
+        int k = 0;
+        for (int i = 0; i < n; i += 2) orden[k++] = i;
+        for (int i = 1; i < n; i += 2) orden[k++] = i;
+    } else if (dist == DIST_SESGADA) {
+        for (int i = 0; i < n; i++) orden[i] = n - 1 - i; // LIFO
+    } else {
+        orden = generarOrden(n, g);
+    }
+    vector<int> direcciones(n);
+    unsigned long long suma = 0;
+
+    Cronometro c1;
+    for (int i = 0; i < n; i++) direcciones[i] = m.reservar(tamanios[i]);
+    r.agregar("buddy", "reservar", n, c1.ns());
+
+    Cronometro c2;
+    for (int i = 0; i < n; i++) {
+        int j = orden[i];
+        if (direcciones[j] >= 0) m.liberar(direcciones[j], tamanios[j]);
+    }
+    r.agregar("buddy", "liberar", n, c2.ns());
+
+    // Medio pool ocupado; cada ciclo suelta un bloque al azar y pide otro
+    int vivos = n / 2;
+    for (int i = 0; i < vivos; i++) direcciones[i] = m.reservar(tamanios[i]);
+    Cronometro c3;
+    for (int i = 0; i < n; i++) {
+        int j = orden[i] % vivos;
+        if (direcciones[j] >= 0) m.liberar(direcciones[j], tamanios[j]);
+        tamanios[j] = tamanios[i];
+        direcciones[j] = m.reservar(tamanios[j]);
+        suma += direcciones[j];
+    }
+    r.agregar("buddy", "liberar_reservar", n, c3.ns());
+
+    sumidero = sumidero + suma + m.fallos;
+}
+
+// Registro concurrente (el de registroProcesos) con H hilos: cada fase
+// (insertar, buscar, eliminar) reparte los n PIDs en H tramos, uno por
+// hilo. Con F = 1 el registro tiene un solo cerrojo global; con
+// F = FRAGMENTOS_PROCESOS, uno por fragmento.
+struct DatoBench {
+    int prioridad;
+};
+
+template <int F>
+struct FaseConcurrente {
+    static void correr(RegistroConcurrente<DatoBench, F>* t, const vector<int>* pids, int fase,
+                       long desde, long hasta, unsigned long long* suma) {
+        unsigned long long s = 0;
+        for (long i = desde; i < hasta; i++) {
+            int pid = (*pids)[i];
+            if (fase == 1) {
+                DatoBench* d = t->buscar(pid);
+                s += d != NULL ? d->prioridad : 0;
+                continue;
+            }
+            t->escribir(pid);
+            DatoBench* d = t->buscarTomado(pid);
+            if (fase == 0 && d == NULL) {
+                t->alta(pid)->prioridad = 1 + (int)(i % 100);
+                s++;
+            } else if (fase == 2 && d != NULL) {
+                t->baja(pid, d);
+                s++;
+            }
+            t->soltar(pid);
+        }
+        *suma = s;
+    }
+};
+
+template <int F, int H>
+void casoConcurrente(int n, int dist, Generador& g, Reporte& r) {
+    static const char* operaciones[] = { "insertar", "buscar", "eliminar" };
+    char estructura[24];
+    snprintf(estructura, sizeof(estructura), "%s_%d", F == 1 ? "global" : "fragmentada", H);
+    vector<int> pids = generarPIDs(n, dist, g);
+    vector<int> orden = generarOrden(n, g);
+    vector<int> buscados(n);
+    for (int i = 0; i < n; i++) buscados[i] = pids[orden[i]];
+    RegistroConcurrente<DatoBench, F>* t = new RegistroConcurrente<DatoBench, F>();
+    vector<unsigned long long> sumas(H);
+
+    for (int fase = 0; fase < 3; fase++) {
+        const vector<int>* lista = fase == 0 ? &pids : &buscados;
+        vector<thread> hilos;
+        Cronometro c;
+        for (int i = 0; i < H; i++) {
+            hilos.push_back(thread(FaseConcurrente<F>::correr, t, lista, fase, (long)n * i / H,
+                                   (long)n * (i + 1) / H, &sumas[i]));
+        }
+        for (int i = 0; i < H; i++) hilos[i].join();
+        r.agregar(estructura, operaciones[fase], n, c.ns());
+        for (int i = 0; i < H; i++) sumidero = sumidero + sumas[i];
+    }
+    delete t;
+}
+
+int main(int argc, char* argv[]) {
+    Opciones op;
+    if (!leerOpciones(argc, argv, op)) {
+        imprimirUso(argv[0]);
+        return 2;
+    }
+    Variante variantes[] = {
+        { "listas", casoListas },
+        { "listas_buddy", casoListasBuddy },
+        { "listas_1024", casoListasAcotadas },
+        { "listas_niveles", casoListasNiveles },
+        { "listas_wal", casoListasBitacora },
+        { "soa", casoSoA },
+        { "buddy", casoBuddy },
+        { "global_1", casoConcurrente<1, 1> },
+        { "global_4", casoConcurrente<1, 4> },
+        { "global_8", casoConcurrente<1, 8> },
+        { "fragmentada_1", casoConcurrente<FRAGMENTOS_PROCESOS, 1> },
+        { "fragmentada_4", casoConcurrente<FRAGMENTOS_PROCESOS, 4> },
+        { "fragmentada_8", casoConcurrente<FRAGMENTOS_PROCESOS, 8> }
+    };
+    return correrBenchmark("gestor", variantes, sizeof(variantes) / sizeof(variantes[0]), op);
+}
@@ -0,0 +1,211 @@
+// Benchmark del simulador de "primer codigo": mide Cola (encolar,
+// desencolar), Pila (push, pop), Lista (insertarFinal), el simulador de
+// eventos discretos, el round-robin con quantum, la ejecucin en paralelo
+// con robo de trabajo y la cola de listos compartida (sin bloqueos contra
+// Cola con mutex).
+//
+// Son estructuras sin bsqueda por clave, as que la distribucin solo
+// cambia los PIDs y prioridades guardados, no el recorrido. La Lista va en
+// su propia variante porque insertarFinal recorre la lista entera: con
+// tamaos grandes se corta por presupuesto sin arrastrar a las otras.
+//
+// Compilar y correr en Linux:  make -C benchmark run
+
+#define SIN_MAIN
+#include "../primer codigo/main.cpp"
+#include "medicion.h"
+
+#include <vector>
+
+// Procesos ya armados (fuera de la medicin): las estructuras solo guardan punteros
+Proceso* prepararProcesos(int n, int dist, Generador& g) {
+    std::vector<int> pids = generarPIDs(n, dist, g);
+    std::vector<int> prioridades = generarPrioridades(n, dist, g);
+    unsigned nombre = tablaNombres.internar("proceso_de_prueba");
+    Proceso* procesos = new Proceso[n];
+    for (int i = 0; i < n; i++) {
+        procesos[i].id = pids[i];
+        procesos[i].nombre = nombre;
+        procesos[i].prioridad = prioridades[i];
+        procesos[i].estado = "Listo";
+        procesos[i].tiempoCPU = 1 + (int)g.rango(100);
+    }
+    return procesos;
+}
+
+void casoColaPila(int n, int dist, Generador& g, Reporte& r) {
+    Proceso* procesos = prepararProcesos(n, dist, g);
+    Cola cola;
+    Pila pila;
+    unsigned long long suma = 0;
+
+    Cronometro c1;
+    for (int i = 0; i < n; i++) cola.encolar(&procesos[i]);
+    r.agregar("cola", "encolar", n, c1.ns());
+
+    Cronometro c2;
+    Proceso* p;
+    while (cola.desencolar(p)) suma += p->id;
+    r.agregar("cola", "desencolar", n, c2.ns());
+
+    Cronometro c3;
+    for (int i = 0; i < n; i++) pila.push(&procesos[i]);
+    r.agregar("pila", "push", n, c3.ns());
+
+    Cronometro c4;
+    while (pila.pop(p)) suma += p->prioridad;
+    r.agregar("pila", "pop", n, c4.ns());
+
+    // Carga estable: encolar, ejecutar y pasar a la pila de a uno
+    Cronometro c5;
+    for (int i = 0; i < n; i++) {
+        cola.encolar(&procesos[i]);
+        if (cola.desencolar(p)) pila.push(p);
+        if (pila.pop(p)) suma += p->tiempoCPU;
+    }
+    r.agregar("cola+pila", "ciclo_ejecucion", n, c5.ns());
+
+    sumidero = sumidero + suma;
+    delete[] procesos;
+}
+
+void casoLista(int n, int dist, Generador& g, Reporte& r) {
+    Proceso* procesos = prepararProcesos(n, dist, g);
+    Lista lista;
+
+    Cronometro c1;
+    for (int i = 0; i < n; i++) lista.insertarFinal(&procesos[i]);
+    r.agregar("lista", "insertar_final", n, c1.ns());
+
+    sumidero = sumidero + (unsigned long long)(size_t)lista.inicio;
+    delete[] procesos;
+}
+
+// Simulacin de n procesos sintticos con 4 CPU al 75% de carga. La
+// distribucin no aplica (la carga la genera el simulador); se usa la
+// semilla del caso. Se informa el costo por evento y por proceso.
+void casoSimulador(int n, int dist, Generador& g, Reporte& r) {
+    (void)dist;
+    Cronometro c;
+    ResultadoSimulacion res = simularCarga(n, 4, 10, 30, g.siguiente());
+    long long ns = c.ns();
+    r.agregar("simulador", "evento", (long long)res.eventos, ns);
+    r.agregar("simulador", "proceso", res.procesos, ns);
+    sumidero = sumidero + (unsigned long long)res.makespan;
+}
+
+// Round-robin de n procesos (quantum 10 ms, rfagas de media 100 ms) que
+// llegan en t = 0, de a un turno y adelantando rondas. Los turnos de a uno
+// miden Cola::rotar; adelantando, el costo se informa por proceso.
+void casoRoundRobin(int n, int dist, Generador& g, Reporte& r) {
+    (void)dist;
+    unsigned long long semilla = g.siguiente();
+    Cronometro c1;
+    ResultadoRoundRobin paso = simularRoundRobin(n, 10, 100, semilla, false);
+    r.agregar("round_robin", "turno", paso.turnos, c1.ns());
+
+    Cronometro c2;
+    ResultadoRoundRobin adelantado = simularRoundRobin(n, 10, 100, semilla, true);
+    r.agregar("round_robin", "proceso_adelantando", adelantado.procesos, c2.ns());
+    sumidero = sumidero + (unsigned long long)(paso.makespan ^ adelantado.makespan);
+}
+
+#ifdef CON_HILOS
+// Despacho con H hilos. Con la distribucin uniforme los procesos arrancan
+// repartidos entre los ncleos; con las otras, todos en el ncleo 0, as
+// el reparto depende solo de los robos. El trabajo por proceso es corto
+// (tiempoCPU * 10 vueltas) para que pese el costo de despachar.
+template <int H>
+void casoParalelo(int n, int dist, Generador& g, Reporte& r) {
+    static const char* nombres[] = { "", "paralelo_1", "paralelo_2", "", "paralelo_4",
+                                     "", "", "", "paralelo_8" };
+    Proceso* procesos = prepararProcesos(n, dist, g);
+    std::vector<Proceso*> punteros(n), terminados;
+    for (int i = 0; i < n; i++) punteros[i] = &procesos[i];
+    terminados.reserve(n);
+
+    Cronometro c;
+    ResultadoParalelo res = ejecutarEnParalelo(&punteros[0], n, H, 10, dist == DIST_UNIFORME, terminados);
+    long long ns = c.ns();
+    r.agregar(nombres[H], "despachar", n, ns);
+    sumidero = sumidero + terminados.size() + (unsigned long long)(res.maxPorNucleo + res.robos);
+    delete[] procesos;
+}
+
+// Contencin en la cola de listos compartida: H hilos encolan y desencolan
+// de a uno (cada hilo hace n / H pares), as todos pelean por los dos
+// extremos todo el tiempo. La distribucin solo cambia los procesos.
+const char* nombreContencion(const char* cola, int hilos) {
+    static char nombre[24];
+    snprintf(nombre, sizeof(nombre), "%s_%d", cola, hilos);
+    return nombre;
+}
+
+template <typename C>
+void contender(C* cola, Proceso* procesos, long desde, long hasta, unsigned long long* suma) {
+    Proceso* p;
+    unsigned long long s = 0;
+    for (long i = desde; i < hasta; i++) {
+        while (!cola->encolar(&procesos[i])) std::this_thread::yield();
+        while (!cola->desencolar(p)) std::this_thread::yield();
+        s += p->id;
+    }
+    *suma = s;
+}
+
+template <typename C>
+void correrContencion(C& cola, const char* nombre, int hilos, int n, int dist, Generador& g, Reporte& r) {
+    Proceso* procesos = prepararProcesos(n, dist, g);
+    std::vector<unsigned long long> sumas(hilos);
+    std::vector<std::thread> trabajadores;
+    Cronometro c;
+    for (int i = 0; i < hilos; i++) {
+        trabajadores.push_back(std::thread(contender<C>, &cola, procesos, (long)n * i / hilos,
+                                           (long)n * (i + 1) / hilos, &sumas[i]));
+    }
+    for (int i = 0; i < hilos; i++) trabajadores[i].join();
+    r.agregar(nombreContencion(nombre, hilos), "encolar+desencolar", n, c.ns());
+    for (int i = 0; i < hilos; i++) sumidero = sumidero + sumas[i];
+    delete[] procesos;
+}
+
+template <int H>
+void casoMPMC(int n, int dist, Generador& g, Reporte& r) {
+    ColaMPMC<Proceso*> cola(1024);
+    correrContencion(cola, "mpmc", H, n, dist, g, r);
+}
+
+template <int H>
+void casoColaMutex(int n, int dist, Generador& g, Reporte& r) {
+    ColaConMutex cola;
+    correrContencion(cola, "cola_mutex", H, n, dist, g, r);
+}
+#endif
+
+int main(int argc, char* argv[]) {
+    Opciones op;
+    if (!leerOpciones(argc, argv, op)) {
+        imprimirUso(argv[0]);
+        return 2;
+    }
+    Variante variantes[] = {
+        { "cola_pila", casoColaPila },
+        { "lista", casoLista },
+        { "simulador", casoSimulador },
+        { "round_robin", casoRoundRobin }
+#ifdef CON_HILOS
+        , { "paralelo_1", casoParalelo<1> },
+        { "paralelo_2", casoParalelo<2> },
+        { "paralelo_4", casoParalelo<4> },
+        { "paralelo_8", casoParalelo<8> },
+        { "mpmc_1", casoMPMC<1> }, { "cola_mutex_1", casoColaMutex<1> },
+        { "mpmc_2", casoMPMC<2> }, { "cola_mutex_2", casoColaMutex<2> },
+        { "mpmc_4", casoMPMC<4> }, { "cola_mutex_4", casoColaMutex<4> },
+        { "mpmc_8", casoMPMC<8> }, { "cola_mutex_8", casoColaMutex<8> },
+        { "mpmc_16", casoMPMC<16> }, { "cola_mutex_16", casoColaMutex<16> },
+        { "mpmc_32", casoMPMC<32> }, { "cola_mutex_32", casoColaMutex<32> },
+        { "mpmc_64", casoMPMC<64> }, { "cola_mutex_64", casoColaMutex<64> }
+#endif
+    };
+    return correrBenchmark("primer", variantes, sizeof(variantes) / sizeof(variantes[0]), op);
+}
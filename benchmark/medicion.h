@@ -0,0 +1,319 @@
+#ifndef MEDICION_H
+#define MEDICION_H
+
+// Utilidades comunes de los benchmarks (solo Linux): reloj, distribuciones
+// de PIDs y prioridades, ejecucin de cada caso en un proceso hijo y salida
+// en tabla y en CSV.
+//
+// Cada caso (distribucin + tamao) corre en un hijo creado con fork(): as
+// arranca con las estructuras globales vacas y el pico de RSS que devuelve
+// wait4() es solo el de ese caso. Un caso que tarda ms que el presupuesto
+// hace que se omitan los tamaos mayores; uno que no termina en diez veces
+// el presupuesto se corta con alarm() (las operaciones ya medidas se informan).
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>
+
+// --- RELOJ ---
+
+inline long long ahoraNs() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// Acumula resultados de las operaciones para que el compilador no las quite
+volatile unsigned long long sumidero = 0;
+
+// --- GENERADOR PSEUDOALEATORIO (xorshift64*, reproducible) ---
+
+struct Generador {
+    unsigned long long estado;
+
+    Generador(unsigned long long semilla) {
+        estado = semilla ? semilla : 88172645463325252ULL;
+    }
+
+    unsigned long long siguiente() {
+        estado ^= estado >> 12;
+        estado ^= estado << 25;
+        estado ^= estado >> 27;
+        return estado * 2685821657736338717ULL;
+    }
+
+    // Entero en [0, n)
+    unsigned rango(unsigned n) {
+        return (unsigned)((siguiente() >> 32) * n >> 32);
+    }
+
+    // Real en [0, 1)
+    double real() {
+        return (siguiente() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+// --- DISTRIBUCIONES ---
+
+enum Distribucion {
+    DIST_UNIFORME,   // PIDs 1..n mezclados, prioridades uniformes en [1, 1000]
+    DIST_SESGADA,    // PIDs 1..n en orden, prioridades concentradas en pocos valores bajos
+    DIST_ADVERSARIA  // PIDs que chocan en el hash, prioridades estrictamente decrecientes
+};
+
+const int CANT_DISTRIBUCIONES = 3;
+
+inline const char* nombreDistribucion(int d) {
+    switch (d) {
+        case DIST_UNIFORME: return "uniforme";
+        case DIST_SESGADA: return "sesgada";
+        case DIST_ADVERSARIA: return "adversaria";
+    }
+    return "?";
+}
+
+inline void mezclar(std::vector<int>& v, Generador& g) {
+    for (size_t i = v.size(); i > 1; i--) {
+        unsigned j = g.rango((unsigned)i);
+        int t = v[i - 1];
+        v[i - 1] = v[j];
+        v[j] = t;
+    }
+}
+
+// n PIDs distintos y positivos.
+// La versin adversaria usa mltiplos del inverso de 2654435769 (la
+// constante del hash de Fibonacci de TablaPID): pid * 2654435769 da
+// 1, 2, 3, ... mdulo 2^32, as que todos caen en las primeras casillas
+// y el sondeo lineal forma un solo bloque gigante.
+inline std::vector<int> generarPIDs(int n, int dist, Generador& g) {
+    std::vector<int> pids;
+    pids.reserve(n);
+    if (dist == DIST_ADVERSARIA) {
+        const unsigned inverso = 340573321u; // 2654435769 * 340573321 = 1 (mod 2^32)
+        for (unsigned k = 1; (int)pids.size() < n; k++) {
+            unsigned p = k * inverso;
+            if (p > 0 && p < 0x80000000u) pids.push_back((int)p);
+        }
+        return pids;
+    }
+    for (int i = 1; i <= n; i++) pids.push_back(i);
+    if (dist == DIST_UNIFORME) mezclar(pids, g);
+    return pids;
+}
+
+// n prioridades (>= 1) en el orden en que se crean los procesos
+inline std::vector<int> generarPrioridades(int n, int dist, Generador& g) {
+    std::vector<int> prioridades(n);
+    for (int i = 0; i < n; i++) {
+        if (dist == DIST_UNIFORME) {
+            prioridades[i] = 1 + (int)g.rango(1000);
+        } else if (dist == DIST_SESGADA) {
+            double u = g.real();
+            prioridades[i] = 1 + (int)(1000 * u * u * u * u); // La mayora cerca de 1
+        } else {
+            prioridades[i] = n - i; // Cada nuevo es el ms urgente: sube hasta la raz
+        }
+    }
+    return prioridades;
+}
+
+// --- RESULTADOS ---
+
+// Lo que el hijo le manda al padre por cada operacin medida
+struct Medicion {
+    char estructura[32];
+    char operacion[32];
+    long long ops;
+    long long ns;
+};
+
+// Parmetros de la lnea de comandos, comunes a los dos benchmarks
+struct Opciones {
+    long minimo;
+    long maximo;
+    double presupuesto; // Segundos: si un caso tarda ms, no se prueban tamaos mayores
+    const char* csv;
+    const char* etiqueta;
+    const char* variante; // Si no es NULL, solo se corre la variante con ese nombre
+    unsigned long long semilla;
+
+    Opciones() {
+        minimo = 1000;
+        maximo = 10000000;
+        presupuesto = 20;
+        csv = NULL;
+        etiqueta = "";
+        variante = NULL;
+        semilla = 12345;
+    }
+};
+
+inline bool leerOpciones(int argc, char* argv[], Opciones& op) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (i + 1 >= argc) return false;
+        if (a == "--min") op.minimo = atol(argv[++i]);
+        else if (a == "--max") op.maximo = atol(argv[++i]);
+        else if (a == "--presupuesto") op.presupuesto = atof(argv[++i]);
+        else if (a == "--csv") op.csv = argv[++i];
+        else if (a == "--etiqueta") op.etiqueta = argv[++i];
+        else if (a == "--variante") op.variante = argv[++i];
+        else if (a == "--semilla") op.semilla = strtoull(argv[++i], NULL, 10);
+        else return false;
+    }
+    return op.minimo > 0 && op.maximo >= op.minimo;
+}
+
+inline void imprimirUso(const char* programa) {
+    fprintf(stderr,
+            "Uso: %s [--min N] [--max N] [--presupuesto SEG] [--csv ARCHIVO]\n"
+            "          [--etiqueta TEXTO] [--variante NOMBRE] [--semilla N]\n"
+            "  Mide cada operacion con n = min, 10*min, ... hasta max (por defecto 1e3..1e7)\n"
+            "  y con distribuciones uniforme, sesgada y adversaria.\n",
+            programa);
+}
+
+// El hijo escribe cada medicin en el pipe apenas la toma
+struct Reporte {
+    int fd;
+
+    void agregar(const char* estructura, const char* operacion, long long ops, long long ns) {
+        Medicion m;
+        memset(&m, 0, sizeof(m));
+        strncpy(m.estructura, estructura, sizeof(m.estructura) - 1);
+        strncpy(m.operacion, operacion, sizeof(m.operacion) - 1);
+        m.ops = ops;
+        m.ns = ns;
+        if (write(fd, &m, sizeof(m)) != (ssize_t)sizeof(m)) _exit(3);
+    }
+};
+
+// Un caso: corre todas las operaciones para una distribucin y un tamao
+typedef void (*FuncionCaso)(int n, int dist, Generador& g, Reporte& r);
+
+// Cada variante (por ejemplo, un motor) corre en hijos separados para que
+// el pico de RSS de una no se mezcle con el de otra
+struct Variante {
+    const char* nombre;
+    FuncionCaso caso;
+};
+
+// Corre todos los casos. Cada uno en un hijo; el padre junta las mediciones,
+// el pico de RSS y escribe la tabla (stdout) y el CSV.
+// Columnas del CSV: etiqueta,programa,estructura,operacion,distribucion,n,
+// ops,ns_total,ns_por_op,ops_por_seg,rss_pico_kb (el RSS es el del caso entero).
+inline int correrBenchmark(const char* programa, const Variante* variantes, int cantVariantes,
+                           const Opciones& op) {
+    FILE* csv = NULL;
+    if (op.csv != NULL) {
+        csv = fopen(op.csv, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "No se pudo abrir %s\n", op.csv);
+            return 2;
+        }
+        fprintf(csv, "etiqueta,programa,estructura,operacion,distribucion,n,ops,"
+                     "ns_total,ns_por_op,ops_por_seg,rss_pico_kb\n");
+    }
+
+    printf("%-10s %-15s %-22s %-10s %9s %10s %14s %10s\n",
+           "programa", "estructura", "operacion", "dist", "n", "ns/op", "ops/s", "rss_kb");
+    fflush(stdout);
+
+    int fallas = 0;
+    for (int v = 0; v < cantVariantes; v++) {
+        if (op.variante != NULL && strcmp(op.variante, variantes[v].nombre) != 0) continue;
+        for (int d = 0; d < CANT_DISTRIBUCIONES; d++) {
+            for (long n = op.minimo; n <= op.maximo; n *= 10) {
+                int tubo[2];
+                if (pipe(tubo) != 0) return 2;
+                long long inicio = ahoraNs();
+                pid_t hijo = fork();
+                if (hijo < 0) return 2;
+                if (hijo == 0) {
+                    close(tubo[0]);
+                    alarm((unsigned)(op.presupuesto * 10) + 1);
+                    Generador g(op.semilla + (unsigned long long)d * 1000003ULL + (unsigned long long)n);
+                    Reporte r;
+                    r.fd = tubo[1];
+                    variantes[v].caso((int)n, d, g, r);
+                    close(tubo[1]);
+                    _exit(0);
+                }
+                close(tubo[1]);
+
+                std::vector<Medicion> mediciones;
+                Medicion m;
+                while (read(tubo[0], &m, sizeof(m)) == (ssize_t)sizeof(m)) mediciones.push_back(m);
+                close(tubo[0]);
+
+                int estado = 0;
+                rusage uso;
+                memset(&uso, 0, sizeof(uso));
+                wait4(hijo, &estado, 0, &uso);
+                double segundos = (ahoraNs() - inicio) / 1e9;
+                bool cortado = WIFSIGNALED(estado) && WTERMSIG(estado) == SIGALRM;
+                if (cortado) {
+                    fprintf(stderr, "%s: el caso %s %s n=%ld se corto a los %.0f s\n",
+                            programa, variantes[v].nombre, nombreDistribucion(d), n, segundos);
+                } else if (!WIFEXITED(estado) || WEXITSTATUS(estado) != 0) {
+                    fprintf(stderr, "%s: el caso %s %s n=%ld termino con error\n",
+                            programa, variantes[v].nombre, nombreDistribucion(d), n);
+                    fallas++;
+                }
+
+                for (size_t i = 0; i < mediciones.size(); i++) {
+                    const Medicion& x = mediciones[i];
+                    double nsPorOp = x.ops > 0 ? (double)x.ns / x.ops : 0;
+                    double opsPorSeg = x.ns > 0 ? x.ops * 1e9 / x.ns : 0;
+                    printf("%-10s %-15s %-22s %-10s %9ld %10.1f %14.0f %10ld\n",
+                           programa, x.estructura, x.operacion, nombreDistribucion(d),
+                           n, nsPorOp, opsPorSeg, uso.ru_maxrss);
+                    if (csv != NULL) {
+                        fprintf(csv, "%s,%s,%s,%s,%s,%ld,%lld,%lld,%.2f,%.0f,%ld\n",
+                                op.etiqueta, programa, x.estructura, x.operacion,
+                                nombreDistribucion(d), n, x.ops, x.ns, nsPorOp, opsPorSeg,
+                                uso.ru_maxrss);
+                    }
+                }
+                fflush(stdout);
+
+                if (cortado) break;
+                if (segundos > op.presupuesto && n * 10 <= op.maximo) {
+                    fprintf(stderr, "%s: %s %s n=%ld tardo %.1f s (presupuesto %.0f s); "
+                                    "se omiten los tamanos mayores\n",
+                            programa, variantes[v].nombre, nombreDistribucion(d), n,
+                            segundos, op.presupuesto);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (csv != NULL) fclose(csv);
+    return fallas == 0 ? 0 : 1;
+}
+
+// Mide el intervalo entre dos llamadas: Cronometro c; ...; r.agregar(..., c.ns())
+struct Cronometro {
+    long long inicio;
+
+    Cronometro() {
+        inicio = ahoraNs();
+    }
+
+    long long ns() const {
+        return ahoraNs() - inicio;
+    }
+};
+
+#endif
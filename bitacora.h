@@ -0,0 +1,382 @@
+#ifndef BITACORA_H
+#define BITACORA_H
+
+#include <cstddef> // NULL
+#include <cstdio>  // FILE, fflush
+#include <cstring> // memcpy, memcmp
+#include <ctime>   // time, para la poca
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Bitcora de escritura anticipada (WAL) del gestor.
+//
+// Cada operacin que cambia el estado agrega un registro corto al final
+// del archivo:
+//
+//   crc (4) | largo del contenido (4) | tipo (1) | contenido
+//
+// El crc (CRC-32) cubre largo, tipo y contenido: al reproducir, el primer
+// registro incompleto o con crc distinto marca el final (lo que qued a
+// medio escribir en un corte) y el archivo se recorta ah.
+//
+// Confirmacin en grupo: los registros se juntan en un bfer y se mandan
+// al disco con un solo fsync cada 'intervaloMs' milisegundos (o cuando se
+// llena el bfer), en lugar de un fsync por operacin. El intervalo se
+// revisa al anotar, as que el gestor confirma lo pendiente antes de cada
+// lectura que puede bloquear (confirmarPendientes): una operacin queda
+// durable a lo sumo 'intervaloMs' despus de hecha o antes de esperar ms
+// entrada, lo que pase primero. Con intervaloMs = 0 cada operacin se
+// sincroniza antes de volver.
+//
+// La cabecera del archivo lleva dos pocas (nmeros al azar): la de esta
+// bitcora y la de la instantnea sobre la que se aplica (0 = el estado
+// vaco). As se detecta una bitcora que no corresponde a la instantnea
+// cargada. Tambin guarda con qu opciones se escribi lo que cambia el
+// resultado de reproducirla: el envejecimiento y el planificador deciden
+// qu proceso sale en cada desencolar, y el pool buddy si una reserva entra.
+
+const char MAGIA_BITACORA[8] = { 'G', 'E', 'S', 'T', 'W', 'A', 'L', '2' };
+
+enum TipoRegistroWAL {
+    WAL_CREAR = 1,     // pid, prioridad, nombre
+    WAL_BORRAR = 2,    // pid
+    WAL_ENCOLAR = 3,   // pid
+    WAL_DESENCOLAR = 4,
+    WAL_RESERVAR = 5,  // pid, KB
+    WAL_LIBERAR = 6,
+    WAL_PRIORIDAD = 7  // pid, prioridad nueva
+};
+
+struct CabeceraBitacora {
+    char magia[8];
+    unsigned marcaOrden; // Igual que en las instantneas
+    unsigned envejecimiento; // --envejecimiento con que se escribi (0 = sin envejecimiento)
+    unsigned buddyKB;        // Tamao del pool buddy (0 = solo pila)
+    unsigned niveles;        // 1 si el planificador era por niveles
+    unsigned long long epoca;
+    unsigned long long epocaBase; // poca de la instantnea de partida (0 = vaco)
+};
+
+// CRC-32 (polinomio 0xEDB88320), con tabla
+inline unsigned crc32(const void* datos, size_t n, unsigned crc = 0) {
+    static unsigned tabla[256];
+    static bool lista = false;
+    if (!lista) {
+        for (unsigned i = 0; i < 256; i++) {
+            unsigned c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            tabla[i] = c;
+        }
+        lista = true;
+    }
+    const unsigned char* p = (const unsigned char*)datos;
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++) crc = tabla[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+inline long long relojMs() {
+#ifdef _WIN32
+    return (long long)GetTickCount64();
+#else
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000 + t.tv_nsec / 1000000;
+#endif
+}
+
+// Nmero al azar para identificar una bitcora o una instantnea
+inline unsigned long long nuevaEpoca() {
+    static unsigned long long contador = 0;
+    unsigned long long x = (unsigned long long)time(NULL) * 6364136223846793005ULL
+                         + (unsigned long long)relojMs() * 1442695040888963407ULL
+                         + (unsigned long long)(size_t)&contador + ++contador;
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    return x != 0 ? x : 1;
+}
+
+// Manda al disco lo ya escrito en 'f' (antes de dar por buena una
+// instantnea y vaciar la bitcora)
+inline bool sincronizarArchivo(FILE* f) {
+    if (fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+// Reemplaza 'ruta' por 'temporal'. Con 'durable' el cambio de nombre
+// tambin queda en el disco antes de volver: si no, un corte podra dejar
+// la instantnea vieja junto a una bitcora ya vaciada
+inline bool reemplazarArchivo(const char* temporal, const char* ruta, bool durable) {
+#ifdef _WIN32
+    DWORD banderas = MOVEFILE_REPLACE_EXISTING;
+    if (durable) banderas |= MOVEFILE_WRITE_THROUGH;
+    return MoveFileExA(temporal, ruta, banderas) != 0;
+#else
+    if (rename(temporal, ruta) != 0) return false;
+    if (!durable) return true;
+    // El nombre vive en el directorio: sincronizarlo a l
+    const char* barra = strrchr(ruta, '/');
+    size_t largo = barra == NULL ? 0 : (barra == ruta ? 1 : (size_t)(barra - ruta));
+    char* directorio = new char[largo + 2];
+    if (largo == 0) {
+        strcpy(directorio, ".");
+    } else {
+        memcpy(directorio, ruta, largo);
+        directorio[largo] = '\0';
+    }
+    int fd = open(directorio, O_RDONLY);
+    delete[] directorio;
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    return ok;
+#endif
+}
+
+// Recorre los registros vlidos de una bitcora ya leda (o mapeada)
+struct LectorBitacora {
+    const char* datos;
+    long long tamanio;
+    long long pos; // Inicio del prximo registro (al terminar: fin de lo vlido)
+
+    // Registro actual
+    unsigned char tipo;
+    const char* contenido;
+    unsigned largo;
+
+    LectorBitacora(const char* d, long long t) {
+        datos = d;
+        tamanio = t;
+        pos = sizeof(CabeceraBitacora);
+        tipo = 0;
+        contenido = NULL;
+        largo = 0;
+    }
+
+    // false al llegar al final o a un registro roto
+    bool siguiente() {
+        if (tamanio - pos < 9) return false;
+        unsigned crc, n;
+        memcpy(&crc, datos + pos, 4);
+        memcpy(&n, datos + pos + 4, 4);
+        if ((long long)n > tamanio - pos - 9) return false;
+        if (crc32(datos + pos + 4, 5 + (size_t)n) != crc) return false;
+        tipo = (unsigned char)datos[pos + 8];
+        contenido = datos + pos + 9;
+        largo = n;
+        pos += 9 + n;
+        return true;
+    }
+
+    int entero(unsigned i) const { // i-simo entero del contenido
+        int v;
+        memcpy(&v, contenido + 4 * i, 4);
+        return v;
+    }
+};
+
+struct Bitacora {
+    enum { TAM_BUFER = 1 << 16 };
+
+    int fd; // -1 = desactivada
+    char* bufer;
+    size_t usado;
+    unsigned long long epoca;
+    unsigned long long epocaBase;
+    long long registros; // Registros en el archivo (incluidos los del bfer)
+    int intervaloMs;
+    long long ultimoSync;
+    long long syncs; // Cantidad de fsync hechos
+    bool sinConfirmar; // Hay registros anotados despus del ltimo fsync
+    unsigned envejecimiento; // Estos tres se escriben en la cabecera
+    unsigned buddyKB;
+    unsigned niveles;
+
+    Bitacora() {
+        fd = -1;
+        bufer = NULL;
+        usado = 0;
+        epoca = epocaBase = 0;
+        registros = 0;
+        intervaloMs = 10;
+        ultimoSync = 0;
+        syncs = 0;
+        sinConfirmar = false;
+        envejecimiento = buddyKB = niveles = 0;
+    }
+
+    ~Bitacora() {
+        cerrar();
+    }
+
+    bool activa() const {
+        return fd >= 0;
+    }
+
+    // Abre para agregar al final del archivo, que ya debe tener 'validos'
+    // bytes correctos (lo que sigue se descarta). Si validos == 0 escribe
+    // una cabecera nueva con esas pocas.
+    bool abrir(const char* ruta, long long validos, unsigned long long e, unsigned long long base,
+               long long cantRegistros) {
+#ifdef _WIN32
+        fd = _open(ruta, _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+        if (fd < 0 || _chsize(fd, (long)validos) != 0 || _lseeki64(fd, validos, SEEK_SET) < 0) return falla();
+#else
+        fd = open(ruta, O_RDWR | O_CREAT, 0644);
+        if (fd < 0 || ftruncate(fd, (off_t)validos) != 0 || lseek(fd, (off_t)validos, SEEK_SET) < 0) return falla();
+#endif
+        bufer = new char[TAM_BUFER];
+        usado = 0;
+        registros = cantRegistros;
+        if (validos == 0) {
+            if (!escribirCabecera(e, base)) return falla();
+        } else {
+            epoca = e;
+            epocaBase = base;
+        }
+        ultimoSync = relojMs();
+        return true;
+    }
+
+    bool falla() {
+        cerrar();
+        return false;
+    }
+
+    bool escribirCabecera(unsigned long long e, unsigned long long base) {
+        CabeceraBitacora c;
+        memset(&c, 0, sizeof(c));
+        memcpy(c.magia, MAGIA_BITACORA, sizeof(c.magia));
+        c.marcaOrden = 0x01020304u;
+        c.epoca = e;
+        c.epocaBase = base;
+        c.envejecimiento = envejecimiento;
+        c.buddyKB = buddyKB;
+        c.niveles = niveles;
+        epoca = e;
+        epocaBase = base;
+        registros = 0;
+        return escribirTodo((const char*)&c, sizeof(c)) && sincronizarDisco();
+    }
+
+    bool escribirTodo(const char* p, size_t n) {
+        while (n > 0) {
+#ifdef _WIN32
+            int w = _write(fd, p, (unsigned)n);
+#else
+            ssize_t w = write(fd, p, n);
+#endif
+            if (w <= 0) return false;
+            p += w;
+            n -= (size_t)w;
+        }
+        return true;
+    }
+
+    bool sincronizarDisco() {
+        syncs++;
+#ifdef _WIN32
+        return _commit(fd) == 0;
+#elif defined(__linux__)
+        return fdatasync(fd) == 0; // No hace falta actualizar la fecha del archivo
+#else
+        return fsync(fd) == 0;
+#endif
+    }
+
+    // Manda el bfer al archivo y, si 'durable', espera a que llegue al disco
+    bool vaciar(bool durable) {
+        if (!activa()) return true;
+        bool ok = escribirTodo(bufer, usado);
+        usado = 0;
+        if (durable) {
+            ok = sincronizarDisco() && ok;
+            ultimoSync = relojMs();
+            sinConfirmar = false;
+        }
+        return ok;
+    }
+
+    // Antes de quedarse esperando entrada: lo anotado no puede seguir en el
+    // bfer un tiempo indefinido. Si no hay nada pendiente no hace un fsync.
+    bool confirmarPendientes() {
+        if (!activa() || !sinConfirmar) return true;
+        return vaciar(true);
+    }
+
+    // Agrega un registro. Retorna false si fall la escritura.
+    bool anotar(unsigned char tipo, const int* enteros, int cantEnteros, const char* texto, unsigned largoTexto) {
+        if (!activa()) return true;
+        unsigned n = 4 * cantEnteros + largoTexto;
+        if (usado + 9 + n > TAM_BUFER && !vaciar(false)) return false;
+        if (9 + n > TAM_BUFER) { // Registro enorme: directo al archivo
+            char* grande = new char[9 + n];
+            armar(grande, tipo, enteros, cantEnteros, texto, largoTexto);
+            bool ok = escribirTodo(grande, 9 + n);
+            delete[] grande;
+            if (!ok) return false;
+        } else {
+            armar(bufer + usado, tipo, enteros, cantEnteros, texto, largoTexto);
+            usado += 9 + n;
+        }
+        registros++;
+        sinConfirmar = true;
+        if (intervaloMs == 0 || relojMs() - ultimoSync >= intervaloMs) return vaciar(true);
+        return true;
+    }
+
+    static void armar(char* d, unsigned char tipo, const int* enteros, int cantEnteros, const char* texto,
+                      unsigned largoTexto) {
+        unsigned n = 4 * cantEnteros + largoTexto;
+        memcpy(d + 4, &n, 4);
+        d[8] = (char)tipo;
+        if (cantEnteros > 0) memcpy(d + 9, enteros, 4 * cantEnteros);
+        if (largoTexto > 0) memcpy(d + 9 + 4 * cantEnteros, texto, largoTexto);
+        unsigned crc = crc32(d + 4, 5 + (size_t)n);
+        memcpy(d, &crc, 4);
+    }
+
+    // Empieza una bitcora vaca sobre la instantnea 'base' (despus de
+    // guardarla): se borra lo anotado y cambia la poca
+    bool reiniciar(unsigned long long base) {
+        if (!activa()) return true;
+        usado = 0;
+#ifdef _WIN32
+        if (_chsize(fd, 0) != 0 || _lseeki64(fd, 0, SEEK_SET) < 0) return false;
+#else
+        if (ftruncate(fd, 0) != 0 || lseek(fd, 0, SEEK_SET) < 0) return false;
+#endif
+        return escribirCabecera(nuevaEpoca(), base);
+    }
+
+    void cerrar() {
+        if (fd >= 0) {
+            vaciar(true);
+#ifdef _WIN32
+            _close(fd);
+#else
+            close(fd);
+#endif
+        }
+        fd = -1;
+        delete[] bufer;
+        bufer = NULL;
+    }
+};
+
+#endif
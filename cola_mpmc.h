@@ -0,0 +1,103 @@
+#ifndef COLA_MPMC_H
+#define COLA_MPMC_H
+
+// Requiere C++11 (<atomic>). Solo lo incluyen los modos con hilos.
+#include <atomic>
+#include <cstddef> // size_t, ptrdiff_t
+
+// Cola FIFO sin bloqueos para varios productores y varios consumidores
+// (el arreglo circular acotado de D. Vyukov).
+//
+// Cada casilla guarda, adems del dato, un nmero de secuencia que dice en
+// qu vuelta est: si vale 'pos' la casilla espera al productor que tom la
+// posicin 'pos'; si vale 'pos + 1', al consumidor de esa posicin. Un hilo
+// reserva su posicin con un compare-and-swap sobre 'fin' (o 'frente') y
+// despus trabaja solo en su casilla, as que productores y consumidores no
+// se pisan y nunca se libera memoria mientras otro la lee.
+//
+// Es acotada: encolar devuelve false si est llena y desencolar devuelve
+// false si est vaca, en lugar de esperar.
+template <typename T>
+struct ColaMPMC {
+    struct Casilla {
+        std::atomic<size_t> secuencia;
+        T dato;
+    };
+
+    Casilla* casillas;
+    size_t mascara; // capacidad - 1 (la capacidad es potencia de 2)
+
+    // 'fin' lo tocan los productores y 'frente' los consumidores: cada uno
+    // en su propia lnea de cach (relleno en vez de alignas, como en DequeRobo)
+    char rellenoInicio[64];
+    std::atomic<size_t> fin;
+    char rellenoFin[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> frente;
+    char rellenoFrente[64 - sizeof(std::atomic<size_t>)];
+
+    // La capacidad se redondea hacia arriba a potencia de 2 (mnimo 2)
+    ColaMPMC(size_t capacidad) {
+        size_t c = 2;
+        while (c < capacidad) c *= 2;
+        casillas = new Casilla[c];
+        mascara = c - 1;
+        for (size_t i = 0; i < c; i++) casillas[i].secuencia.store(i, std::memory_order_relaxed);
+        fin.store(0, std::memory_order_relaxed);
+        frente.store(0, std::memory_order_relaxed);
+    }
+
+    ~ColaMPMC() {
+        delete[] casillas;
+    }
+
+    size_t capacidad() const {
+        return mascara + 1;
+    }
+
+    bool encolar(T x) {
+        size_t pos = fin.load(std::memory_order_relaxed);
+        Casilla* c;
+        while (true) {
+            c = &casillas[pos & mascara];
+            size_t sec = c->secuencia.load(std::memory_order_acquire);
+            ptrdiff_t dif = (ptrdiff_t)(sec - pos); // Con long (32 bits en Windows) fallaba al pasar 2^31
+            if (dif == 0) {
+                if (fin.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false; // Llena: la casilla todava tiene el dato de la vuelta anterior
+            } else {
+                pos = fin.load(std::memory_order_relaxed); // Otro productor se adelant
+            }
+        }
+        c->dato = x;
+        c->secuencia.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool desencolar(T& x) {
+        size_t pos = frente.load(std::memory_order_relaxed);
+        Casilla* c;
+        while (true) {
+            c = &casillas[pos & mascara];
+            size_t sec = c->secuencia.load(std::memory_order_acquire);
+            ptrdiff_t dif = (ptrdiff_t)(sec - (pos + 1));
+            if (dif == 0) {
+                if (frente.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false; // Vaca: el productor de esta posicin no lleg
+            } else {
+                pos = frente.load(std::memory_order_relaxed);
+            }
+        }
+        x = c->dato;
+        c->secuencia.store(pos + mascara + 1, std::memory_order_release); // Libre para la prxima vuelta
+        return true;
+    }
+
+    // Aproximado si otros hilos la estn usando
+    bool vacia() const {
+        return fin.load(std::memory_order_relaxed) == frente.load(std::memory_order_relaxed);
+    }
+};
+
+#endif
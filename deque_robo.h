@@ -0,0 +1,138 @@
+#ifndef DEQUE_ROBO_H
+#define DEQUE_ROBO_H
+
+// Requiere C++11 (<atomic>). Solo lo incluyen los modos con hilos.
+#include <atomic>
+#include <cstddef> // NULL
+
+// Deque de robo de trabajo (Chase-Lev, con los rdenes de memoria de
+// L, Pop, Cohen y Zappa Nardelli, "Correct and Efficient Work-Stealing
+// for Weak Memory Models", 2013).
+//
+// Cada hilo es dueo de un deque: apila y saca por abajo sin bloqueos y,
+// salvo cuando queda un solo elemento, sin operaciones atmicas caras. Los
+// dems hilos roban por arriba con un compare-and-swap. T debe ser un tipo
+// trivial y pequeo (punteros); T() significa "vaco".
+//
+// Cuando el arreglo circular se llena se copia a uno del doble de tamao.
+// El viejo no se libera enseguida porque un ladrn puede estar leyndolo:
+// queda en una lista y se libera en el destructor.
+template <typename T>
+struct DequeRobo {
+    struct Arreglo {
+        long long capacidad; // Potencia de 2
+        std::atomic<T>* datos;
+        Arreglo* anterior;   // Arreglos retirados, para liberarlos al final
+
+        Arreglo(long long c) {
+            capacidad = c;
+            datos = new std::atomic<T>[c];
+            anterior = NULL;
+        }
+
+        ~Arreglo() {
+            delete[] datos;
+        }
+
+        T leer(long long i) const {
+            return datos[i & (capacidad - 1)].load(std::memory_order_relaxed);
+        }
+
+        void escribir(long long i, T x) {
+            datos[i & (capacidad - 1)].store(x, std::memory_order_relaxed);
+        }
+    };
+
+    // 'arriba' y 'abajo' en lneas de cach distintas: una la escriben los
+    // ladrones y la otra el dueo. Se separan con relleno y no con alignas
+    // porque en C++11 new[] no respeta alineaciones mayores que la normal.
+    char rellenoInicio[64];
+    std::atomic<long long> arriba;
+    char rellenoArriba[64 - sizeof(std::atomic<long long>)];
+    std::atomic<long long> abajo;
+    char rellenoAbajo[64 - sizeof(std::atomic<long long>)];
+    std::atomic<Arreglo*> arreglo;
+    char rellenoFinal[64 - sizeof(std::atomic<Arreglo*>)];
+
+    DequeRobo() {
+        arriba.store(0, std::memory_order_relaxed);
+        abajo.store(0, std::memory_order_relaxed);
+        arreglo.store(new Arreglo(64), std::memory_order_relaxed);
+    }
+
+    ~DequeRobo() {
+        Arreglo* a = arreglo.load(std::memory_order_relaxed);
+        while (a != NULL) {
+            Arreglo* viejo = a->anterior;
+            delete a;
+            a = viejo;
+        }
+    }
+
+    // Solo el dueo
+    void apilar(T x) {
+        long long b = abajo.load(std::memory_order_relaxed);
+        long long t = arriba.load(std::memory_order_acquire);
+        Arreglo* a = arreglo.load(std::memory_order_relaxed);
+        if (b - t > a->capacidad - 1) a = crecer(a, t, b);
+        a->escribir(b, x);
+        std::atomic_thread_fence(std::memory_order_release);
+        abajo.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Solo el dueo. Devuelve T() si el deque est vaco.
+    T sacar() {
+        long long b = abajo.load(std::memory_order_relaxed) - 1;
+        Arreglo* a = arreglo.load(std::memory_order_relaxed);
+        abajo.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long t = arriba.load(std::memory_order_relaxed);
+
+        T x = T();
+        if (t <= b) {
+            x = a->leer(b);
+            if (t == b) { // ltimo elemento: compite con los ladrones
+                if (!arriba.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed)) {
+                    x = T();
+                }
+                abajo.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            abajo.store(b + 1, std::memory_order_relaxed);
+        }
+        return x;
+    }
+
+    // Cualquier hilo. Devuelve T() si estaba vaco o si otro gan la carrera.
+    T robar() {
+        long long t = arriba.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long b = abajo.load(std::memory_order_acquire);
+        if (t >= b) return T();
+
+        Arreglo* a = arreglo.load(std::memory_order_acquire);
+        T x = a->leer(t);
+        if (!arriba.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed)) {
+            return T();
+        }
+        return x;
+    }
+
+    // Aproximado si otros hilos lo estn usando
+    long long tamanio() const {
+        long long n = abajo.load(std::memory_order_relaxed) - arriba.load(std::memory_order_relaxed);
+        return n > 0 ? n : 0;
+    }
+
+    Arreglo* crecer(Arreglo* a, long long t, long long b) {
+        Arreglo* nuevo = new Arreglo(a->capacidad * 2);
+        for (long long i = t; i < b; i++) nuevo->escribir(i, a->leer(i));
+        nuevo->anterior = a;
+        arreglo.store(nuevo, std::memory_order_release);
+        return nuevo;
+    }
+};
+
+#endif
@@ -0,0 +1,374 @@
+#ifndef INDICE_PRIORIDAD_H
+#define INDICE_PRIORIDAD_H
+
+#include <cstddef> // NULL
+#include <climits> // INT_MIN, INT_MAX
+
+// ndice ordenado por (prioridad, pid) -> V: un rbol B+.
+//
+// Las entradas estn en hojas de hasta CAPACIDAD claves contiguas, enlazadas
+// en orden, as que recorrer un rango es bajar una vez (O(log n)) y leer
+// hojas seguidas. Cada nodo interno guarda, por hijo, cuntas entradas hay
+// debajo: contar las entradas de un rango de prioridades tambin cuesta
+// O(log n), sin recorrerlas. La mnima y la mxima estn en la primera y la
+// ltima hoja (O(1)).
+//
+// Borrar no fusiona nodos a medio llenar (como hacen muchas bases de
+// datos): solo se quitan las hojas que quedan vacas, y sus padres si
+// tambin quedan vacos. La altura nunca pasa la que tuvo con el mximo de
+// entradas.
+template <typename V>
+struct IndicePrioridad {
+    enum { CAPACIDAD = 32, ALTURA_MAXIMA = 16 };
+
+    struct Clave {
+        int prioridad;
+        int pid;
+    };
+
+    static bool menor(const Clave& a, const Clave& b) {
+        if (a.prioridad != b.prioridad) return a.prioridad < b.prioridad;
+        return a.pid < b.pid;
+    }
+
+    struct Hoja {
+        int cantidad;
+        Clave claves[CAPACIDAD];
+        V valores[CAPACIDAD];
+        Hoja* anterior;
+        Hoja* siguiente;
+    };
+
+    struct Interno {
+        int cantidad;             // Hijos
+        Clave claves[CAPACIDAD];  // Cota inferior de cada hijo (la del hijo 0 no se usa)
+        long cuentas[CAPACIDAD];  // Entradas debajo de cada hijo
+        void* hijos[CAPACIDAD];   // Hoja* en el ltimo nivel interno, Interno* en los dems
+    };
+
+    // Posicin de una entrada para recorrer en orden
+    struct Cursor {
+        Hoja* hoja; // NULL = terminado
+        int i;
+
+        bool valido() const {
+            return hoja != NULL;
+        }
+
+        const Clave& clave() const {
+            return hoja->claves[i];
+        }
+
+        V valor() const {
+            return hoja->valores[i];
+        }
+
+        void avanzar() {
+            if (++i == hoja->cantidad) {
+                hoja = hoja->siguiente;
+                i = 0;
+            }
+        }
+    };
+
+    void* raiz;  // Hoja* si altura == 0
+    int altura;  // Niveles de nodos internos
+    long cantidad;
+    long long sumaPrioridades; // Para el promedio
+    Hoja* primera;
+    Hoja* ultima;
+
+    IndicePrioridad() {
+        iniciar();
+    }
+
+    ~IndicePrioridad() {
+        liberar(raiz, altura);
+    }
+
+    void iniciar() {
+        Hoja* h = nuevaHoja();
+        raiz = h;
+        altura = 0;
+        cantidad = 0;
+        sumaPrioridades = 0;
+        primera = ultima = h;
+    }
+
+    void vaciar() {
+        liberar(raiz, altura);
+        iniciar();
+    }
+
+    static Hoja* nuevaHoja() {
+        Hoja* h = new Hoja;
+        h->cantidad = 0;
+        h->anterior = h->siguiente = NULL;
+        return h;
+    }
+
+    static void liberar(void* n, int nivel) {
+        if (nivel > 0) {
+            Interno* in = (Interno*)n;
+            for (int i = 0; i < in->cantidad; i++) liberar(in->hijos[i], nivel - 1);
+            delete in;
+        } else {
+            delete (Hoja*)n;
+        }
+    }
+
+    // Primera posicin de la hoja con clave >= k (bsqueda binaria)
+    static int posicionEn(const Hoja* h, const Clave& k) {
+        int a = 0, b = h->cantidad;
+        while (a < b) {
+            int m = (a + b) / 2;
+            if (menor(h->claves[m], k)) a = m + 1;
+            else b = m;
+        }
+        return a;
+    }
+
+    // Hijo por el que se baja para buscar k: el ltimo con cota <= k
+    static int hijoPara(const Interno* n, const Clave& k) {
+        int a = 1, b = n->cantidad;
+        while (a < b) {
+            int m = (a + b) / 2;
+            if (menor(k, n->claves[m])) b = m;
+            else a = m + 1;
+        }
+        return a - 1;
+    }
+
+    static void insertarEnHoja(Hoja* h, int i, const Clave& k, V valor) {
+        for (int j = h->cantidad; j > i; j--) {
+            h->claves[j] = h->claves[j - 1];
+            h->valores[j] = h->valores[j - 1];
+        }
+        h->claves[i] = k;
+        h->valores[i] = valor;
+        h->cantidad++;
+    }
+
+    static void insertarHijo(Interno* n, int i, const Clave& k, void* hijo, long cuenta) {
+        for (int j = n->cantidad; j > i; j--) {
+            n->claves[j] = n->claves[j - 1];
+            n->cuentas[j] = n->cuentas[j - 1];
+            n->hijos[j] = n->hijos[j - 1];
+        }
+        n->claves[i] = k;
+        n->cuentas[i] = cuenta;
+        n->hijos[i] = hijo;
+        n->cantidad++;
+    }
+
+    static long sumaCuentas(const Interno* n) {
+        long s = 0;
+        for (int i = 0; i < n->cantidad; i++) s += n->cuentas[i];
+        return s;
+    }
+
+    // La clave (prioridad, pid) no debe estar (el pid es nico)
+    void insertar(int prioridad, int pid, V valor) {
+        Clave k;
+        k.prioridad = prioridad;
+        k.pid = pid;
+        Interno* camino[ALTURA_MAXIMA];
+        int pos[ALTURA_MAXIMA];
+        void* n = raiz;
+        for (int d = 0; d < altura; d++) {
+            Interno* in = (Interno*)n;
+            int i = hijoPara(in, k);
+            camino[d] = in;
+            pos[d] = i;
+            in->cuentas[i]++;
+            n = in->hijos[i];
+        }
+        cantidad++;
+        sumaPrioridades += prioridad;
+
+        Hoja* h = (Hoja*)n;
+        int i = posicionEn(h, k);
+        if (h->cantidad < CAPACIDAD) {
+            insertarEnHoja(h, i, k, valor);
+            return;
+        }
+
+        // Hoja llena: la mitad de arriba pasa a una hoja nueva, a su derecha
+        const int mitad = CAPACIDAD / 2;
+        Hoja* nueva = nuevaHoja();
+        for (int j = mitad; j < CAPACIDAD; j++) {
+            nueva->claves[j - mitad] = h->claves[j];
+            nueva->valores[j - mitad] = h->valores[j];
+        }
+        h->cantidad = mitad;
+        nueva->cantidad = CAPACIDAD - mitad;
+        nueva->anterior = h;
+        nueva->siguiente = h->siguiente;
+        if (h->siguiente != NULL) h->siguiente->anterior = nueva;
+        else ultima = nueva;
+        h->siguiente = nueva;
+        if (i <= mitad) insertarEnHoja(h, i, k, valor);
+        else insertarEnHoja(nueva, i - mitad, k, valor);
+
+        // El nodo nuevo se agrega al padre; si el padre est lleno, se parte
+        // igual y se sigue hacia arriba
+        void* hijo = nueva;
+        Clave cota = nueva->claves[0];
+        long cuentaIzquierda = h->cantidad;
+        long cuentaHijo = nueva->cantidad;
+        for (int d = altura - 1; d >= 0; d--) {
+            Interno* p = camino[d];
+            int j = pos[d] + 1;
+            p->cuentas[j - 1] = cuentaIzquierda;
+            if (p->cantidad < CAPACIDAD) {
+                insertarHijo(p, j, cota, hijo, cuentaHijo);
+                return;
+            }
+            Interno* q = new Interno;
+            q->cantidad = 0;
+            for (int t = mitad; t < CAPACIDAD; t++) {
+                insertarHijo(q, q->cantidad, p->claves[t], p->hijos[t], p->cuentas[t]);
+            }
+            p->cantidad = mitad;
+            if (j <= mitad) insertarHijo(p, j, cota, hijo, cuentaHijo);
+            else insertarHijo(q, j - mitad, cota, hijo, cuentaHijo);
+            hijo = q;
+            cota = q->claves[0];
+            cuentaIzquierda = sumaCuentas(p);
+            cuentaHijo = sumaCuentas(q);
+        }
+
+        // Se parti la raz: el rbol crece un nivel
+        Interno* r = new Interno;
+        r->cantidad = 0;
+        insertarHijo(r, 0, cota, raiz, cuentaIzquierda);
+        insertarHijo(r, 1, cota, hijo, cuentaHijo);
+        raiz = r;
+        altura++;
+    }
+
+    // false si la clave no estaba
+    bool eliminar(int prioridad, int pid) {
+        Clave k;
+        k.prioridad = prioridad;
+        k.pid = pid;
+        Interno* camino[ALTURA_MAXIMA];
+        int pos[ALTURA_MAXIMA];
+        void* n = raiz;
+        for (int d = 0; d < altura; d++) {
+            Interno* in = (Interno*)n;
+            camino[d] = in;
+            pos[d] = hijoPara(in, k);
+            n = in->hijos[pos[d]];
+        }
+        Hoja* h = (Hoja*)n;
+        int i = posicionEn(h, k);
+        if (i == h->cantidad || menor(k, h->claves[i])) return false;
+
+        for (int j = i + 1; j < h->cantidad; j++) {
+            h->claves[j - 1] = h->claves[j];
+            h->valores[j - 1] = h->valores[j];
+        }
+        h->cantidad--;
+        cantidad--;
+        sumaPrioridades -= prioridad;
+        for (int d = 0; d < altura; d++) camino[d]->cuentas[pos[d]]--;
+        if (h->cantidad > 0 || altura == 0) return true;
+
+        // Hoja vaca: sale de la cadena de hojas y de su padre (y el padre
+        // de su abuelo, si tambin queda vaco)
+        if (h->anterior != NULL) h->anterior->siguiente = h->siguiente;
+        else primera = h->siguiente;
+        if (h->siguiente != NULL) h->siguiente->anterior = h->anterior;
+        else ultima = h->anterior;
+        delete h;
+        for (int d = altura - 1; d >= 0; d--) {
+            Interno* p = camino[d];
+            for (int j = pos[d] + 1; j < p->cantidad; j++) {
+                p->claves[j - 1] = p->claves[j];
+                p->cuentas[j - 1] = p->cuentas[j];
+                p->hijos[j - 1] = p->hijos[j];
+            }
+            p->cantidad--;
+            if (p->cantidad > 0) break;
+            delete p; // La raz nunca queda vaca: siempre tiene al menos dos hijos
+        }
+
+        // Raz con un solo hijo: el rbol baja un nivel
+        while (altura > 0 && ((Interno*)raiz)->cantidad == 1) {
+            Interno* r = (Interno*)raiz;
+            raiz = r->hijos[0];
+            delete r;
+            altura--;
+        }
+        return true;
+    }
+
+    // Cursor en la primera entrada con clave >= k
+    Cursor buscarDesde(const Clave& k) const {
+        void* n = raiz;
+        for (int d = 0; d < altura; d++) n = ((Interno*)n)->hijos[hijoPara((Interno*)n, k)];
+        Cursor c;
+        c.hoja = (Hoja*)n;
+        c.i = posicionEn(c.hoja, k);
+        if (c.i == c.hoja->cantidad) { // Est al principio de la hoja siguiente
+            c.hoja = c.hoja->siguiente;
+            c.i = 0;
+        }
+        return c;
+    }
+
+    // Cursor en la primera entrada con prioridad >= prioridad
+    Cursor desde(int prioridad) const {
+        Clave k;
+        k.prioridad = prioridad;
+        k.pid = INT_MIN;
+        return buscarDesde(k);
+    }
+
+    // Cursor en la primera entrada despus de (prioridad, pid)
+    Cursor despuesDe(int prioridad, int pid) const {
+        Clave k;
+        k.prioridad = prioridad;
+        k.pid = pid;
+        Cursor c = buscarDesde(k);
+        if (c.valido() && !menor(k, c.clave())) c.avanzar(); // Es la misma clave
+        return c;
+    }
+
+    // Entradas con clave < k, sumando las cuentas de los hijos de la izquierda
+    long menoresQue(const Clave& k) const {
+        long total = 0;
+        void* n = raiz;
+        for (int d = 0; d < altura; d++) {
+            Interno* in = (Interno*)n;
+            int i = hijoPara(in, k);
+            for (int j = 0; j < i; j++) total += in->cuentas[j];
+            n = in->hijos[i];
+        }
+        return total + posicionEn((Hoja*)n, k);
+    }
+
+    // Entradas con prioridad en [minimo, maximo]
+    long contar(int minimo, int maximo) const {
+        if (minimo > maximo) return 0;
+        Clave a, b;
+        a.prioridad = minimo;
+        a.pid = INT_MIN;
+        b.prioridad = maximo == INT_MAX ? maximo : maximo + 1;
+        b.pid = INT_MIN;
+        long hasta = maximo == INT_MAX ? cantidad : menoresQue(b);
+        return hasta - menoresQue(a);
+    }
+
+    // Precondicin: cantidad > 0
+    int minimaPrioridad() const {
+        return primera->claves[0].prioridad;
+    }
+
+    int maximaPrioridad() const {
+        return ultima->claves[ultima->cantidad - 1].prioridad;
+    }
+};
+
+#endif
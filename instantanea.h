@@ -0,0 +1,245 @@
+#ifndef INSTANTANEA_H
+#define INSTANTANEA_H
+
+#include <cstddef> // NULL
+#include <cstdio>  // FILE, fwrite
+#include <cstring> // memcmp, memcpy
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX // Si no, windows.h define min y max como macros
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Formato binario de las instantneas del gestor (versin 2).
+//
+// El archivo es una cabecera seguida de secciones de registros de tamao
+// fijo. Nada guarda punteros: los procesos se nombran por PID y los
+// nombres por su ndice en la tabla de nombres, cuyo texto est al final
+// en una sola arena. Cada seccin empieza en un desplazamiento mltiplo
+// de 8 contado desde el inicio del archivo.
+//
+//   cabecera | procesos | nombres | cola | bloques | libres | texto de los nombres
+//
+// 'libres' solo se usa con el pool buddy: son los bloques libres en el orden
+// de sus listas, para que despus de cargar se sigan entregando las mismas
+// direcciones que sin haber guardado.
+//
+// Los nmeros se guardan en el orden de bytes de la mquina que escribi el
+// archivo; 'marcaOrden' permite detectar un archivo de otra arquitectura.
+
+const char MAGIA_INSTANTANEA[8] = { 'G', 'E', 'S', 'T', 'P', 'R', 'O', 'C' };
+const unsigned VERSION_INSTANTANEA = 2; // 2: pocas de la bitcora en la cabecera
+const unsigned MARCA_ORDEN = 0x01020304u;
+
+enum {
+    INST_COLA_NIVELES = 1, // La cola est en orden de salida (si no, es el arreglo del montculo)
+    INST_BUDDY = 2         // Los bloques tienen direcciones del pool buddy
+};
+
+struct CabeceraInstantanea {
+    char magia[8];
+    unsigned version;
+    unsigned marcaOrden;
+    unsigned banderas;
+    int buddyKB;                // Tamao del pool buddy (0 si no hay)
+    long long procesos;         // En el orden de la lista
+    long long nombres;          // Nombres distintos
+    long long enCola;
+    long long bloques;          // Desde la base de la pila hasta el tope
+    long long libres;           // Bloques libres del pool buddy
+    long long bytesTexto;
+    long long desProcesos;      // Desplazamientos de cada seccin
+    long long desNombres;
+    long long desCola;
+    long long desBloques;
+    long long desLibres;
+    long long desTexto;
+    long long tamanioArchivo;
+    unsigned long long llegadas; // Contador de orden de llegada de la cola
+    unsigned long long epoca;    // Identifica esta instantnea (ver bitacora.h)
+    unsigned long long epocaWAL; // Bitcora que estaba activa al guardar (0 = ninguna)
+    long long registrosWAL;      // Registros de esa bitcora que ya estn incluidos
+};
+
+struct RegistroProceso {
+    int pid;
+    int prioridad;
+    unsigned nombre; // ndice en la seccin de nombres
+    unsigned relleno;
+};
+
+struct RegistroNombre {
+    unsigned inicio; // Desplazamiento dentro del texto
+    unsigned largo;
+};
+
+struct RegistroCola {
+    int pid;
+    int prioridad;
+    unsigned long long orden;
+};
+
+struct RegistroBloque {
+    int pid;
+    int tamanio;
+    int direccion; // -1 sin pool buddy
+    int relleno;
+};
+
+struct RegistroLibre {
+    int direccion;
+    int orden;
+};
+
+// Escritura en bloques grandes: los registros se juntan en un bfer y se
+// mandan al archivo de a 1 MB, en lugar de un fwrite por registro
+struct EscritorBinario {
+    enum { TAM_BUFER = 1 << 20 };
+
+    FILE* archivo;
+    char* bufer;
+    size_t usado;
+    long long escritos; // Bytes escritos en total (la posicin actual)
+    bool ok;
+
+    EscritorBinario(FILE* f) {
+        archivo = f;
+        bufer = new char[TAM_BUFER];
+        usado = 0;
+        escritos = 0;
+        ok = f != NULL;
+    }
+
+    ~EscritorBinario() {
+        delete[] bufer;
+    }
+
+    void vaciar() {
+        if (ok && usado > 0 && fwrite(bufer, 1, usado, archivo) != usado) ok = false;
+        usado = 0;
+    }
+
+    void escribir(const void* datos, size_t n) {
+        const char* p = (const char*)datos;
+        while (n > 0) {
+            if (usado == TAM_BUFER) vaciar();
+            size_t parte = TAM_BUFER - usado < n ? TAM_BUFER - usado : n;
+            memcpy(bufer + usado, p, parte);
+            usado += parte;
+            p += parte;
+            n -= parte;
+            escritos += parte;
+        }
+    }
+
+    // Rellena con ceros hasta un mltiplo de 8
+    void alinear() {
+        static const char ceros[8] = { 0 };
+        if (escritos % 8 != 0) escribir(ceros, (size_t)(8 - escritos % 8));
+    }
+};
+
+// Archivo de solo lectura mapeado en memoria: las pginas se leen del disco
+// (o de la cach del sistema) recin cuando se tocan.
+struct ArchivoMapeado {
+    const char* datos;
+    long long tamanio;
+#ifdef _WIN32
+    HANDLE archivo;
+    HANDLE mapeo;
+#endif
+
+    ArchivoMapeado() {
+        datos = NULL;
+        tamanio = 0;
+#ifdef _WIN32
+        archivo = INVALID_HANDLE_VALUE;
+        mapeo = NULL;
+#endif
+    }
+
+    ~ArchivoMapeado() {
+        cerrar();
+    }
+
+    bool abrir(const char* ruta) {
+        cerrar();
+#ifdef _WIN32
+        archivo = CreateFileA(ruta, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (archivo == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER t;
+        if (!GetFileSizeEx(archivo, &t) || t.QuadPart == 0) return false;
+        tamanio = t.QuadPart;
+        mapeo = CreateFileMappingA(archivo, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapeo == NULL) return false;
+        datos = (const char*)MapViewOfFile(mapeo, FILE_MAP_READ, 0, 0, 0);
+        return datos != NULL;
+#else
+        int fd = open(ruta, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // El mapeo sigue valiendo sin el descriptor
+        if (p == MAP_FAILED) return false;
+        madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL); // Se recorre de principio a fin
+        datos = (const char*)p;
+        tamanio = st.st_size;
+        return true;
+#endif
+    }
+
+    void cerrar() {
+#ifdef _WIN32
+        if (datos != NULL) UnmapViewOfFile(datos);
+        if (mapeo != NULL) CloseHandle(mapeo);
+        if (archivo != INVALID_HANDLE_VALUE) CloseHandle(archivo);
+        mapeo = NULL;
+        archivo = INVALID_HANDLE_VALUE;
+#else
+        if (datos != NULL) munmap((void*)datos, (size_t)tamanio);
+#endif
+        datos = NULL;
+        tamanio = 0;
+    }
+};
+
+// Verifica que una seccin de 'cantidad' registros de 'tam' bytes que
+// empieza en 'desplazamiento' est alineada y entera dentro del archivo
+inline bool seccionValida(long long desplazamiento, long long cantidad, long long tam, long long total) {
+    if (desplazamiento < (long long)sizeof(CabeceraInstantanea) || desplazamiento % 8 != 0) return false;
+    if (cantidad < 0 || desplazamiento > total) return false;
+    return cantidad <= (total - desplazamiento) / tam;
+}
+
+// Revisa la cabecera; retorna NULL si es vlida o el motivo si no lo es
+inline const char* validarCabecera(const ArchivoMapeado& a) {
+    if (a.tamanio < (long long)sizeof(CabeceraInstantanea)) return "el archivo es demasiado corto";
+    const CabeceraInstantanea* c = (const CabeceraInstantanea*)a.datos;
+    if (memcmp(c->magia, MAGIA_INSTANTANEA, sizeof(c->magia)) != 0) return "no es una instantanea del gestor";
+    if (c->marcaOrden != MARCA_ORDEN) return "el archivo es de una maquina con otro orden de bytes";
+    if (c->version != VERSION_INSTANTANEA) return "version de instantanea no soportada";
+    if (c->tamanioArchivo != a.tamanio) return "el archivo esta truncado";
+    if (!seccionValida(c->desProcesos, c->procesos, sizeof(RegistroProceso), a.tamanio)
+        || !seccionValida(c->desNombres, c->nombres, sizeof(RegistroNombre), a.tamanio)
+        || !seccionValida(c->desCola, c->enCola, sizeof(RegistroCola), a.tamanio)
+        || !seccionValida(c->desBloques, c->bloques, sizeof(RegistroBloque), a.tamanio)
+        || !seccionValida(c->desLibres, c->libres, sizeof(RegistroLibre), a.tamanio)
+        || !seccionValida(c->desTexto, c->bytesTexto, 1, a.tamanio)) {
+        return "secciones fuera del archivo";
+    }
+    if (c->procesos > 0x7fffffff || c->enCola > c->procesos) return "cantidades invalidas";
+    return NULL;
+}
+
+#endif
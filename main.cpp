@@ -1,65 +1,563 @@
 #include <iostream>
 #include <string>
+#include <fstream> // Para leer el archivo del modo script
 #include <limits> // Para limpiar el buffer de entrada
 #include <cstdlib> // <stdlib.h> es de C, <cstdlib> es de C++
+#include <algorithm> // sort, para mostrar la cola en orden de ejecucin
+#include <cstring> // strlen, para el modo script
+#include <cstdio> // fopen, rename, para las instantneas
+#include <vector>
+#include "pool_nodos.h" // Pools (slabs) para los nodos de las estructuras
+#include "tabla_pid.h" // ndice hash PID -> proceso
+#include "tabla_concurrente.h" // Registro de procesos partido en fragmentos con cerrojos
+#include "indice_prioridad.h" // ndice ordenado por prioridad (rbol B+)
+#include "tabla_nombres.h" // Nombres internados: cada nombre distinto se guarda una vez
+#include "tabla_soa.h" // Motor alternativo: tabla de procesos en columnas
+#include "memoria_buddy.h" // Modo de memoria con direcciones (asignador buddy)
+#include "instantanea.h" // Formato de las instantneas y archivo mapeado en memoria
+#include "bitacora.h" // Bitcora de escritura anticipada (--wal)
 
 using namespace std;
 
+// --- MTRICAS (SOLO CON -DCON_METRICAS) ---
+// Compilando con -DCON_METRICAS cada operacin base registra su latencia en
+// un histograma, y los recorridos cuntos nodos visitaron en cada llamada
+// (casillas sondeadas por buscarProcesoPorPID, y por lo tanto por
+// estaEnCola; niveles que sube o baja un nodo del montculo; bloques que
+// suelta un borrado). El comando "stats" del modo script los muestra, y
+// los mens al salir. Cada medicin lee el reloj dos veces (unos 20-40 ns),
+// as que las operaciones ms cortas salen infladas. Sin la bandera las
+// macros no generan cdigo.
+#ifdef CON_METRICAS
+#include "metricas.h" // Histogramas de latencia y reloj en nanosegundos
+
+enum OperacionMedida {
+    OP_CREAR,
+    OP_BORRAR,
+    OP_ENCOLAR,
+    OP_EJECUTAR,
+    OP_RESERVAR,
+    OP_LIBERAR,
+    OP_PRIORIDAD,
+    OP_BUSCAR,
+    OP_VISTA,
+    OP_GUARDAR,
+    OPERACIONES_MEDIDAS
+};
+
+enum RecorridoMedido {
+    NODOS_BUSCAR_PID,
+    NODOS_SUBIR,
+    NODOS_BAJAR,
+    NODOS_BLOQUES_BORRADOS,
+    RECORRIDOS_MEDIDOS
+};
+
+Histograma latencias[OPERACIONES_MEDIDAS]; // En nanosegundos
+Histograma visitas[RECORRIDOS_MEDIDOS];    // Nodos por llamada
+
+#define MEDIR_OPERACION(op) Cronometro cronometro(latencias[op])
+#define CONTAR_NODOS(recorrido, n) visitas[recorrido].registrar(n)
+#else
+#define MEDIR_OPERACION(op)
+#define CONTAR_NODOS(recorrido, n) ((void)(n)) // El contador local queda sin usar y se descarta
+#endif
+
 // --- ESTRUCTURAS DE DATOS ---
 
+struct BloqueMemoria; // Declaracin adelantada: el PCB apunta a sus bloques
+
 // Estructura para el Gestor de Procesos (Lista Enlazada)
+// Funciona como bloque de control de proceso (PCB): adems de los datos lleva
+// los enlaces de la lista doble y la posicin en la cola de CPU, de modo que
+// cada estructura puede soltarlo sin tener que recorrerse.
 struct Proceso {
     int pid;
-    string nombre;
+    unsigned nombre; // Id del nombre en tablaNombres (internado)
     int prioridad;
+    int posCola; // Posicin en la cola del planificador (-1 si no est encolado)
+    int bloquesMemoria; // Cuntos bloques de la Pila de Memoria le pertenecen
+    long long kbMemoria; // Suma de los tamaos de esos bloques
+    BloqueMemoria* bloques; // Cadena de sus bloques (el ms reciente primero)
+    Proceso* anterior; // Puntero al proceso anterior en la lista
     Proceso* siguiente; // Puntero al siguiente proceso en la lista
 };
 
 // Estructura para el Gestor de Memoria (Pila)
+// Cada bloque est en dos listas dobles a la vez: la pila global (orden LIFO)
+// y la cadena de bloques de su proceso. As liberar la memoria de un PID solo
+// toca los bloques de ese PID.
 struct BloqueMemoria {
     Proceso* proceso; // Proceso asociado a este bloque de memoria
     int tamanio;
-    BloqueMemoria* siguiente; // Puntero al siguiente bloque en la pila
+    int direccion; // Inicio (en KB) dentro del pool buddy; -1 en el modo solo pila
+    BloqueMemoria* siguiente; // Puntero al siguiente bloque en la pila (hacia la base)
+    BloqueMemoria* anterior; // Puntero al bloque de arriba (hacia el tope)
+    BloqueMemoria* sigDelProceso; // Siguiente bloque del mismo proceso
+    BloqueMemoria* antDelProceso; // Bloque anterior del mismo proceso
 };
 
 // Estructura para el Planificador de CPU (Cola de Prioridad)
+// Cada nodo es una casilla del montculo; la clave se copia aqu para que
+// comparar no tenga que seguir el puntero al proceso.
 struct NodoCola {
     Proceso* proceso; // Apuntador al proceso asociado
-    NodoCola* siguiente; // Apuntador al siguiente nodo en la cola
+    int prioridad; // Copia de proceso->prioridad al momento de encolar
+    unsigned long long orden; // Orden de llegada: desempata prioridades iguales (FIFO)
+};
+
+// Cola de prioridad del planificador: montculo binario mnimo indexado,
+// guardado en un arreglo. La clave es (prioridad, orden de llegada), as que
+// con prioridades iguales se respeta el orden FIFO igual que la lista
+// ordenada anterior. Cada proceso guarda su posicin (posCola), lo que
+// permite saber si est encolado en O(1) y quitarlo en O(log n).
+//
+// Envejecimiento (--envejecimiento E): el tiempo se cuenta en llegadas y un
+// proceso que espera gana un nivel de prioridad cada E llegadas, as que
+// ninguno espera para siempre detrs de los de mayor prioridad. El que
+// lleg en t0 con prioridad p tiene en el instante t prioridad efectiva
+// p - (t - t0) / E; en un mismo t, comparar eso entre dos procesos es lo
+// mismo que comparar p * E + t0, que no depende de t. Esa es la clave del
+// montculo: el envejecimiento no reordena ni recorre nada y extraer sigue
+// siendo O(log n).
+struct ColaPrioridad {
+    NodoCola* nodos;
+    int cantidad;
+    int capacidad;
+    unsigned long long llegadas; // Contador para el campo 'orden'
+    unsigned long long envejecimiento; // E (0 = prioridades estrictas)
+
+    ColaPrioridad() {
+        capacidad = 16;
+        cantidad = 0;
+        llegadas = 0;
+        envejecimiento = 0;
+        nodos = new NodoCola[capacidad];
+    }
+
+    ~ColaPrioridad() {
+        delete[] nodos;
+    }
+
+    bool vacia() const {
+        return cantidad == 0;
+    }
+
+    Proceso* frente() const {
+        return cantidad > 0 ? nodos[0].proceso : NULL;
+    }
+
+    bool antes(const NodoCola& a, const NodoCola& b) const {
+        if (envejecimiento != 0) {
+            unsigned long long limiteA = (unsigned long long)a.prioridad * envejecimiento + a.orden;
+            unsigned long long limiteB = (unsigned long long)b.prioridad * envejecimiento + b.orden;
+            if (limiteA != limiteB) return limiteA < limiteB;
+        }
+        if (a.prioridad != b.prioridad) return a.prioridad < b.prioridad;
+        return a.orden < b.orden;
+    }
+
+    // Prioridad con la que compite ahora el nodo (la suya si no hay envejecimiento)
+    long long prioridadEfectiva(const NodoCola& n) const {
+        if (envejecimiento == 0) return n.prioridad;
+        return n.prioridad - (long long)((llegadas - n.orden) / envejecimiento);
+    }
+
+    // Escribe el nodo en la casilla i y actualiza el ndice del proceso
+    void colocar(int i, const NodoCola& n) {
+        nodos[i] = n;
+        n.proceso->posCola = i;
+    }
+
+    void subir(int i) {
+        NodoCola n = nodos[i];
+        int niveles = 0;
+        while (i > 0) {
+            int padre = (i - 1) / 2;
+            if (!antes(n, nodos[padre])) break;
+            colocar(i, nodos[padre]);
+            i = padre;
+            niveles++;
+        }
+        colocar(i, n);
+        CONTAR_NODOS(NODOS_SUBIR, niveles);
+    }
+
+    void bajar(int i) {
+        NodoCola n = nodos[i];
+        int niveles = 0;
+        while (true) {
+            int hijo = 2 * i + 1;
+            if (hijo >= cantidad) break;
+            if (hijo + 1 < cantidad && antes(nodos[hijo + 1], nodos[hijo])) hijo++;
+            if (!antes(nodos[hijo], n)) break;
+            colocar(i, nodos[hijo]);
+            i = hijo;
+            niveles++;
+        }
+        colocar(i, n);
+        CONTAR_NODOS(NODOS_BAJAR, niveles);
+    }
+
+    void reservar(int n) {
+        if (n <= capacidad) return;
+        NodoCola* nuevos = new NodoCola[n];
+        for (int i = 0; i < cantidad; i++) nuevos[i] = nodos[i];
+        delete[] nodos;
+        nodos = nuevos;
+        capacidad = n;
+    }
+
+    void insertar(Proceso* p) {
+        if (cantidad == capacidad) reservar(capacidad * 2);
+        NodoCola n;
+        n.proceso = p;
+        n.prioridad = p->prioridad;
+        n.orden = llegadas++;
+        colocar(cantidad, n);
+        cantidad++;
+        subir(cantidad - 1);
+    }
+
+    // Devuelve a su lugar el nodo de la casilla i despus de cambiar su clave
+    void reubicar(int i) {
+        if (i > 0 && antes(nodos[i], nodos[(i - 1) / 2])) subir(i);
+        else bajar(i);
+    }
+
+    // Quita el nodo de la casilla i (O(log n)) y devuelve su proceso
+    Proceso* quitarEn(int i) {
+        Proceso* p = nodos[i].proceso;
+        p->posCola = -1;
+        cantidad--;
+        if (i != cantidad) {
+            colocar(i, nodos[cantidad]);
+            reubicar(i);
+        }
+        return p;
+    }
+
+    // Cambia la prioridad del nodo de la casilla i y lo sube o lo baja
+    // (O(log n)). Conserva su orden de llegada: a igual prioridad no pierde
+    // el turno y, con envejecimiento, no pierde lo que ya esper.
+    void cambiarPrioridad(int i, int prioridad) {
+        nodos[i].prioridad = prioridad;
+        reubicar(i);
+    }
+
+    Proceso* extraer() {
+        if (cantidad == 0) return NULL;
+        return quitarEn(0);
+    }
+
+    // Copia un nodo tal cual al final del arreglo, sin reordenar (para
+    // cargar un montculo guardado; despus conviene revisar esMonticulo)
+    void agregarAlFinal(Proceso* p, int prioridad, unsigned long long orden) {
+        if (cantidad == capacidad) reservar(capacidad * 2);
+        NodoCola n;
+        n.proceso = p;
+        n.prioridad = prioridad;
+        n.orden = orden;
+        colocar(cantidad, n);
+        cantidad++;
+    }
+
+    // Ordena todo el arreglo como montculo de abajo hacia arriba: O(n), en
+    // lugar de O(n log n) con una insercin por nodo (carga masiva)
+    void armarMonticulo() {
+        for (int i = cantidad / 2 - 1; i >= 0; i--) bajar(i);
+    }
+
+    bool esMonticulo() const {
+        for (int i = 1; i < cantidad; i++) {
+            if (antes(nodos[i], nodos[(i - 1) / 2])) return false;
+        }
+        return true;
+    }
+};
+
+// Cola del planificador por niveles (alternativa al montculo, se elige con
+// --planificador niveles). Hay una FIFO por prioridad (1..NIVELES) y un mapa
+// de bits de los niveles no vacos en dos pisos: 'resumen' dice qu palabras
+// de 'mapa' tienen algn bit. El nivel ms urgente (el nmero ms bajo) sale
+// con dos "find first set", as que encolar, desencolar y quitar cuestan
+// O(1) sin importar cuntos procesos haya. El orden es el mismo que el del
+// montculo: por prioridad y, a igual prioridad, por llegada.
+// Los nodos viven en un arreglo con lista libre y posCola guarda el ndice
+// del nodo del proceso.
+struct NodoNivel {
+    Proceso* proceso;
+    int siguiente; // Siguiente en la FIFO de su nivel (-1 = fin); en los libres, el siguiente libre
+    int anterior;
+};
+
+struct ColaNiveles {
+    enum { NIVELES = 1024, PALABRAS = NIVELES / 64 };
+
+    NodoNivel* nodos;
+    int capacidad;
+    int usados; // Nodos usados alguna vez
+    int libre;  // Lista de nodos libres
+    int cantidad;
+    int primero[NIVELES]; // Extremos de la FIFO de cada nivel (-1 = vaca)
+    int ultimo[NIVELES];
+    unsigned long long mapa[PALABRAS]; // Bit (p - 1) % 64 de mapa[(p - 1) / 64]: nivel p no vaco
+    unsigned resumen; // Bit w: mapa[w] != 0
+
+    ColaNiveles() {
+        capacidad = 16;
+        usados = 0;
+        libre = -1;
+        cantidad = 0;
+        nodos = new NodoNivel[capacidad];
+        for (int i = 0; i < NIVELES; i++) primero[i] = ultimo[i] = -1;
+        for (int w = 0; w < PALABRAS; w++) mapa[w] = 0;
+        resumen = 0;
+    }
+
+    ~ColaNiveles() {
+        delete[] nodos;
+    }
+
+    static bool admite(int prioridad) {
+        return prioridad >= 1 && prioridad <= NIVELES;
+    }
+
+    bool vacia() const {
+        return cantidad == 0;
+    }
+
+    static int bitMasBajo(unsigned long long v) { // v > 0
+#ifdef __GNUC__
+        return __builtin_ctzll(v);
+#else
+        int b = 0;
+        while ((v & 1) == 0) {
+            v >>= 1;
+            b++;
+        }
+        return b;
+#endif
+    }
+
+    // Nivel (0..NIVELES-1) ms urgente con procesos; -1 si la cola est vaca
+    int nivelMinimo() const {
+        if (resumen == 0) return -1;
+        int w = bitMasBajo(resumen);
+        return w * 64 + bitMasBajo(mapa[w]);
+    }
+
+    // Primer nivel con procesos desde 'desde' inclusive; -1 si no hay
+    int nivelDesde(int desde) const {
+        if (desde >= NIVELES) return -1;
+        int w = desde / 64;
+        unsigned long long bits = mapa[w] & (~0ULL << (desde % 64));
+        if (bits != 0) return w * 64 + bitMasBajo(bits);
+        unsigned resto = w + 1 < PALABRAS ? resumen & (~0u << (w + 1)) : 0;
+        if (resto == 0) return -1;
+        w = bitMasBajo(resto);
+        return w * 64 + bitMasBajo(mapa[w]);
+    }
+
+    // Precondicin: admite(p->prioridad)
+    void insertar(Proceso* p) {
+        int i;
+        if (libre != -1) {
+            i = libre;
+            libre = nodos[i].siguiente;
+        } else {
+            if (usados == capacidad) {
+                NodoNivel* nuevos = new NodoNivel[capacidad * 2];
+                for (int j = 0; j < usados; j++) nuevos[j] = nodos[j];
+                delete[] nodos;
+                nodos = nuevos;
+                capacidad *= 2;
+            }
+            i = usados++;
+        }
+        int nivel = p->prioridad - 1;
+        nodos[i].proceso = p;
+        nodos[i].siguiente = -1;
+        nodos[i].anterior = ultimo[nivel];
+        if (ultimo[nivel] != -1) nodos[ultimo[nivel]].siguiente = i;
+        else primero[nivel] = i;
+        ultimo[nivel] = i;
+        mapa[nivel / 64] |= 1ULL << (nivel % 64);
+        resumen |= 1u << (nivel / 64);
+        p->posCola = i;
+        cantidad++;
+    }
+
+    // Quita el nodo i de su FIFO (O(1)) y devuelve su proceso
+    Proceso* quitarEn(int i) {
+        Proceso* p = nodos[i].proceso;
+        int nivel = p->prioridad - 1;
+        if (nodos[i].anterior != -1) nodos[nodos[i].anterior].siguiente = nodos[i].siguiente;
+        else primero[nivel] = nodos[i].siguiente;
+        if (nodos[i].siguiente != -1) nodos[nodos[i].siguiente].anterior = nodos[i].anterior;
+        else ultimo[nivel] = nodos[i].anterior;
+        if (primero[nivel] == -1) {
+            mapa[nivel / 64] &= ~(1ULL << (nivel % 64));
+            if (mapa[nivel / 64] == 0) resumen &= ~(1u << (nivel / 64));
+        }
+        nodos[i].siguiente = libre;
+        libre = i;
+        p->posCola = -1;
+        cantidad--;
+        return p;
+    }
+
+    Proceso* extraer() {
+        int nivel = nivelMinimo();
+        if (nivel < 0) return NULL;
+        return quitarEn(primero[nivel]);
+    }
 };
 
 // --- PUNTEROS GLOBALES (CABEZAS DE LAS ESTRUCTURAS) ---
 
 Proceso* cabezaProcesos = NULL; // Puntero al inicio de la lista de procesos
+Proceso* finProcesos = NULL; // Puntero al ltimo proceso (insercin al final en O(1))
 BloqueMemoria* topeMemoria = NULL; // Puntero al tope de la pila de memoria
-NodoCola* cabezaCola = NULL; // Puntero a la cabeza de la cola del planificador
+ColaPrioridad colaCPU; // Montculo del planificador de CPU
+ColaNiveles colaNiveles; // Cola por niveles, usada en lugar de colaCPU con --planificador niveles
+bool planificadorNiveles = false;
+// Registro de procesos: ndice PID -> Proceso* y dueo de los nodos de los
+// procesos, partido en fragmentos con un cerrojo cada uno. Con CON_HILOS
+// varios hilos pueden dar de alta, buscar y borrar a la vez; sin hilos hay
+// un solo fragmento y los cerrojos no hacen nada.
+#ifdef CON_HILOS
+const int FRAGMENTOS_PROCESOS = 64;
+#else
+const int FRAGMENTOS_PROCESOS = 1;
+#endif
+RegistroConcurrente<Proceso, FRAGMENTOS_PROCESOS> registroProcesos; // Sincronizado con cabezaProcesos
+// La lista, los ndices ordenados, la cola, la memoria, los nombres y la
+// bitcora son de todo el gestor: las altas y bajas los tocan con este
+// cerrojo tomado (despus del de su fragmento, nunca al revs)
+Cerrojo cerrojoGestor;
+IndicePrioridad<Proceso*> indicePrioridad; // (prioridad, PID) -> Proceso*, en orden: rangos de prioridad
+IndicePrioridad<Proceso*> indiceMemoria; // (-KB, PID) de los procesos con memoria: mayores consumidores primero
+long long kbEnUso = 0; // Suma de los tamaos de todos los bloques de la pila
+
+// Pools de nodos: los procesos (en registroProcesos) y los bloques se sacan de
+// slabs en lugar de un new/delete por nodo. (La cola de CPU ya guarda sus
+// nodos en un arreglo.)
+PoolNodos<BloqueMemoria> poolBloques;
+
+// Nombres de los procesos, guardados una sola vez cada uno
+TablaNombres tablaNombres;
+
+// Pool de memoria con direcciones. Solo est activo si se arranca con
+// --buddy <KB>; si no, la memoria se modela solo con la pila de bloques.
+AsignadorBuddy memoriaBuddy;
 
 // --- FUNCIONES AUXILIARES ---
 
-// Busca un proceso por PID en la lista enlazada
+// Texto del nombre de un proceso
+const char* nombreDe(const Proceso* p) {
+    return tablaNombres.texto(p->nombre);
+}
+
+// Busca un proceso por PID usando el ndice hash (O(1) promedio). Solo
+// toma el cerrojo de lectura del fragmento del PID.
 Proceso* buscarProcesoPorPID(int pid) {
-    Proceso* actual = cabezaProcesos;
-    while (actual != NULL) {
-        if (actual->pid == pid) {
-            return actual; // Retorna el proceso si lo encuentra
-        }
-        actual = actual->siguiente;
+#ifdef CON_METRICAS
+    MEDIR_OPERACION(OP_BUSCAR);
+    unsigned sondeos;
+    Proceso* p = registroProcesos.buscar(pid, sondeos);
+    CONTAR_NODOS(NODOS_BUSCAR_PID, sondeos);
+    return p;
+#else
+    return registroProcesos.buscar(pid);
+#endif
+}
+
+// Aade un proceso al final de la lista doble (O(1))
+void enlazarProceso(Proceso* p) {
+    p->anterior = finProcesos;
+    p->siguiente = NULL;
+    if (finProcesos == NULL) {
+        cabezaProcesos = p; // Si la lista est vaca
+    } else {
+        finProcesos->siguiente = p;
     }
-    return NULL; // Retorna NULL si no se encuentra
+    finProcesos = p;
+}
+
+// Quita un proceso de la lista doble usando sus propios enlaces (O(1))
+void desenlazarProceso(Proceso* p) {
+    if (p->anterior != NULL) p->anterior->siguiente = p->siguiente;
+    else cabezaProcesos = p->siguiente;
+    if (p->siguiente != NULL) p->siguiente->anterior = p->anterior;
+    else finProcesos = p->anterior;
+    p->anterior = p->siguiente = NULL;
+}
+
+// Clave de un proceso en indiceMemoria: con el signo cambiado, el orden
+// ascendente del ndice deja primero al que ms memoria tiene
+int claveMemoria(long long kb) {
+    return kb > numeric_limits<int>::max() ? -numeric_limits<int>::max() : -(int)kb;
+}
+
+// Mueve al proceso dentro de indiceMemoria despus de que sus KB pasaron
+// de 'antes' a p->kbMemoria (O(log n)). Sin memoria no est en el ndice.
+void reindexarMemoria(Proceso* p, long long antes) {
+    if (antes > 0) indiceMemoria.eliminar(claveMemoria(antes), p->pid);
+    if (p->kbMemoria > 0) indiceMemoria.insertar(claveMemoria(p->kbMemoria), p->pid, p);
+}
+
+// Apila un bloque nuevo (Push) y lo engancha al inicio de la cadena del proceso
+BloqueMemoria* apilarBloque(Proceso* p, int tamanio) {
+    BloqueMemoria* nuevo = poolBloques.obtener();
+    nuevo->proceso = p;
+    nuevo->tamanio = tamanio;
+    nuevo->direccion = -1;
+    nuevo->anterior = NULL;
+    nuevo->siguiente = topeMemoria; // Enlaza al bloque anterior
+    if (topeMemoria != NULL) topeMemoria->anterior = nuevo;
+    topeMemoria = nuevo; // El nuevo bloque es ahora el tope
+
+    nuevo->antDelProceso = NULL;
+    nuevo->sigDelProceso = p->bloques;
+    if (p->bloques != NULL) p->bloques->antDelProceso = nuevo;
+    p->bloques = nuevo;
+    p->bloquesMemoria++;
+    p->kbMemoria += tamanio;
+    kbEnUso += tamanio;
+    reindexarMemoria(p, p->kbMemoria - tamanio);
+    return nuevo;
+}
+
+// Desengancha un bloque de la pila y de la cadena de su proceso (O(1), ms
+// O(log n) del ndice de memoria si 'reindexar').
+// Si tena un rango del pool buddy, lo devuelve al asignador; el nodo en s
+// no lo libera: eso le toca al llamador.
+void desapilarBloque(BloqueMemoria* b, bool reindexar = true) {
+    if (b->direccion >= 0) memoriaBuddy.liberar(b->direccion, b->tamanio);
+
+    if (b->anterior != NULL) b->anterior->siguiente = b->siguiente;
+    else topeMemoria = b->siguiente;
+    if (b->siguiente != NULL) b->siguiente->anterior = b->anterior;
+
+    Proceso* p = b->proceso;
+    if (b->antDelProceso != NULL) b->antDelProceso->sigDelProceso = b->sigDelProceso;
+    else p->bloques = b->sigDelProceso;
+    if (b->sigDelProceso != NULL) b->sigDelProceso->antDelProceso = b->antDelProceso;
+    p->bloquesMemoria--;
+    p->kbMemoria -= b->tamanio;
+    kbEnUso -= b->tamanio;
+    if (reindexar) reindexarMemoria(p, p->kbMemoria + b->tamanio);
 }
 
-// Verifica si un proceso ya est en la cola del planificador
+// Verifica si un proceso ya est en la cola del planificador (O(1))
 bool estaEnCola(int pid) {
-    NodoCola* actual = cabezaCola;
-    while (actual != NULL) {
-        if (actual->proceso->pid == pid) {
-            return true; // Retorna true si el PID ya est en la cola
-        }
-        actual = actual->siguiente;
-    }
-    return false; // Retorna false si no est
+    Proceso* p = buscarProcesoPorPID(pid);
+    return p != NULL && p->posCola >= 0;
 }
 
+void confirmarBitacora(); // Declaracin adelantada: la bitcora se define ms abajo
+
 // Limpia el buffer de entrada
 void limpiarBuffer() {
     cin.clear();
@@ -68,6 +566,7 @@ void limpiarBuffer() {
 
 // Limpia la pantalla y espera al usuario (VERSIN CORREGIDA)
 void limpiarYPausar() {
+    confirmarBitacora();
     cout << "Presione Enter para continuar...";
     // 1. Limpia cualquier \n que haya quedado del 'cin >>' anterior
     limpiarBuffer();
@@ -78,83 +577,1374 @@ void limpiarYPausar() {
 }
 
 
-// --- (INICIO DE LA CORRECCIN) FUNCIONES AUXILIARES PARA BORRADO SEGURO ---
+// --- (INICIO DE LA CORRECCIN) FUNCIONES AUXILIARES PARA BORRADO SEGURO ---
+
+/**
+ * (NUEVO) Elimina todas las entradas de un PID de la Pila de Memoria.
+ * Esto es necesario para evitar punteros colgantes cuando se borra un Proceso.
+ * Recorre solo la cadena de bloques del proceso (O(k)), no toda la pila.
+ * Recibe el proceso ya buscado: borrarProceso tiene tomado su fragmento.
+ * Retorna cuntos bloques se liberaron.
+ */
+int eliminarProcesosDePila(Proceso* dueno) {
+    // El ndice de memoria se toca una sola vez, no una por bloque
+    long long antes = dueno->kbMemoria;
+    int liberados = 0;
+    while (dueno->bloques != NULL) {
+        BloqueMemoria* temp = dueno->bloques;
+        desapilarBloque(temp, false); // Lo saca de la pila y de la cadena del proceso
+        poolBloques.devolver(temp);
+        liberados++;
+    }
+    reindexarMemoria(dueno, antes);
+    CONTAR_NODOS(NODOS_BLOQUES_BORRADOS, liberados);
+    return liberados;
+}
+
+/**
+ * (NUEVO) Elimina la entrada de un PID de la Cola del Planificador.
+ * Retorna true si el proceso estaba encolado.
+ */
+bool eliminarProcesoDeCola(Proceso* p) {
+    if (p->posCola < 0) return false; // No est en la cola
+
+    if (planificadorNiveles) colaNiveles.quitarEn(p->posCola); // O(1)
+    else colaCPU.quitarEn(p->posCola); // O(log n) gracias a la posicin guardada
+    return true;
+}
+
+// --- (FIN DE LA CORRECCIN) ---
+
+
+// --- OPERACIONES BASE (SIN MENS NI PAUSAS) ---
+// Los mens y el modo script llaman a estas funciones, as ambos usan
+// exactamente la misma lgica. No leen de cin ni detienen la ejecucin.
+
+enum Resultado {
+    OK,
+    ERROR_PID_INVALIDO,
+    ERROR_PID_DUPLICADO,
+    ERROR_NO_EXISTE,
+    ERROR_NOMBRE_VACIO,
+    ERROR_PRIORIDAD_INVALIDA,
+    ERROR_YA_EN_COLA,
+    ERROR_TAMANIO_INVALIDO,
+    ERROR_SIN_MEMORIA,
+    ERROR_PRIORIDAD_FUERA_DE_RANGO
+};
+
+const char* mensajeError(Resultado r) {
+    switch (r) {
+        case OK: return "OK";
+        case ERROR_PID_INVALIDO: return "El PID debe ser un numero entero positivo.";
+        case ERROR_PID_DUPLICADO: return "Ya existe un proceso con ese PID.";
+        case ERROR_NO_EXISTE: return "El proceso no existe.";
+        case ERROR_NOMBRE_VACIO: return "la cadena no puede estar vacia.";
+        case ERROR_PRIORIDAD_INVALIDA: return "La prioridad debe ser un numero entero positivo.";
+        case ERROR_YA_EN_COLA: return "El proceso ya esta en la cola del planificador.";
+        case ERROR_TAMANIO_INVALIDO: return "Tamano invalido. Debe ser entero positivo.";
+        case ERROR_SIN_MEMORIA: return "No hay un bloque libre de ese tamano en el pool de memoria.";
+        case ERROR_PRIORIDAD_FUERA_DE_RANGO: return "El planificador por niveles solo admite prioridades de 1 a 1024.";
+    }
+    return "Error desconocido.";
+}
+
+// Bitcora de las operaciones (se activa con --wal). Cada operacin base que
+// cambia el estado la anota al terminar bien; si no est activa no hace nada.
+Bitacora bitacora;
+
+void anotarOperacion(TipoRegistroWAL tipo, int cantEnteros, int a, int b, const char* texto, unsigned largo) {
+    int enteros[2] = { a, b };
+    if (!bitacora.anotar((unsigned char)tipo, enteros, cantEnteros, texto, largo)) {
+        cerr << "Error: no se pudo escribir la bitacora; se desactiva.\n";
+        bitacora.cerrar();
+    }
+}
+
+// Antes de cada lectura que puede bloquear (mens, pausas, script sin ms
+// lneas disponibles): con --wal-ms > 0 lo ltimo anotado no debe quedar en
+// el bfer mientras se espera al usuario
+void confirmarBitacora() {
+    if (!bitacora.confirmarPendientes()) {
+        cerr << "Error: no se pudo escribir la bitacora; se desactiva.\n";
+        bitacora.cerrar();
+    }
+}
+
+// Crea un proceso y lo agrega al final de la lista y al ndice. El
+// fragmento del PID queda tomado toda la operacin: otra alta o baja del
+// mismo PID espera, las de otros fragmentos siguen.
+Resultado crearProceso(int pid, const string& nombre, int prioridad) {
+    MEDIR_OPERACION(OP_CREAR);
+    if (pid <= 0) return ERROR_PID_INVALIDO;
+    registroProcesos.escribir(pid);
+    Resultado r = OK;
+    if (registroProcesos.buscarTomado(pid) != NULL) r = ERROR_PID_DUPLICADO;
+    else if (nombre.empty()) r = ERROR_NOMBRE_VACIO;
+    else if (prioridad <= 0) r = ERROR_PRIORIDAD_INVALIDA;
+    if (r != OK) {
+        registroProcesos.soltar(pid);
+        return r;
+    }
+
+    Proceso* nuevo = registroProcesos.alta(pid); // Ya est en el ndice
+    nuevo->pid = pid;
+    nuevo->prioridad = prioridad;
+    nuevo->posCola = -1; // Todava no est en la cola del planificador
+    nuevo->bloquesMemoria = 0;
+    nuevo->kbMemoria = 0;
+    nuevo->bloques = NULL;
+
+    cerrojoGestor.tomar();
+    nuevo->nombre = tablaNombres.internar(nombre);
+    // Insertar al final de la lista (O(1) gracias a finProcesos)
+    enlazarProceso(nuevo);
+    indicePrioridad.insertar(prioridad, pid, nuevo); // Mantener los ndices sincronizados
+    anotarOperacion(WAL_CREAR, 2, pid, prioridad, nombre.data(), (unsigned)nombre.size());
+    cerrojoGestor.soltar();
+    registroProcesos.soltar(pid);
+    return OK;
+}
+
+// Borra un proceso de todas las estructuras. Si se pasan punteros, informa
+// cuntos bloques de memoria se liberaron y si estaba en la cola de CPU.
+Resultado borrarProceso(int pid, int* bloquesLiberados, bool* estabaEnCola) {
+    MEDIR_OPERACION(OP_BORRAR);
+    // 1. Buscar con el ndice (ya no se recorre la lista), con el fragmento
+    // del PID tomado hasta terminar
+    registroProcesos.escribir(pid);
+    Proceso* aEliminar = registroProcesos.buscarTomado(pid);
+    if (aEliminar == NULL) {
+        registroProcesos.soltar(pid);
+        return ERROR_NO_EXISTE;
+    }
+
+    // 2. Desenlazar de la lista principal usando sus propios enlaces (O(1))
+    cerrojoGestor.tomar();
+    desenlazarProceso(aEliminar);
+
+    // --- INICIO DE LA CORRECCIN ---
+    // 2.1 Eliminar de la Pila de Memoria
+    int liberados = eliminarProcesosDePila(aEliminar);
+
+    // 2.2 Eliminar de la Cola de CPU
+    bool enCola = eliminarProcesoDeCola(aEliminar);
+    // --- FIN DE LA CORRECCIN ---
+
+    indicePrioridad.eliminar(aEliminar->prioridad, pid);
+    tablaNombres.soltar(aEliminar->nombre);
+    anotarOperacion(WAL_BORRAR, 1, pid, 0, NULL, 0);
+    cerrojoGestor.soltar();
+    registroProcesos.baja(pid, aEliminar); // Lo saca del ndice y devuelve el nodo al pool
+    registroProcesos.soltar(pid);
+
+    if (bloquesLiberados != NULL) *bloquesLiberados = liberados;
+    if (estabaEnCola != NULL) *estabaEnCola = enCola;
+    return OK;
+}
+
+// Encola un proceso existente en el planificador
+Resultado encolarProceso(int pid) {
+    MEDIR_OPERACION(OP_ENCOLAR);
+    Proceso* p = buscarProcesoPorPID(pid);
+    if (p == NULL) return ERROR_NO_EXISTE;
+    if (p->posCola >= 0) return ERROR_YA_EN_COLA;
+    if (planificadorNiveles) {
+        if (!ColaNiveles::admite(p->prioridad)) return ERROR_PRIORIDAD_FUERA_DE_RANGO;
+        colaNiveles.insertar(p); // O(1)
+    } else {
+        // Insertar en el montculo por prioridad (menor nmero = mayor prioridad).
+        // A igual prioridad sale primero el que lleg antes.
+        colaCPU.insertar(p);
+    }
+    anotarOperacion(WAL_ENCOLAR, 1, pid, 0, NULL, 0);
+    return OK;
+}
+
+// Cambia la prioridad de un proceso (renice). Si est en la cola se
+// reubica ah mismo: O(log n) en el montculo; en la cola por niveles pasa
+// al final de la FIFO de su nuevo nivel, en O(1).
+Resultado cambiarPrioridad(int pid, int prioridad) {
+    MEDIR_OPERACION(OP_PRIORIDAD);
+    Proceso* p = buscarProcesoPorPID(pid);
+    if (p == NULL) return ERROR_NO_EXISTE;
+    if (prioridad <= 0) return ERROR_PRIORIDAD_INVALIDA;
+    if (prioridad == p->prioridad) return OK;
+    if (planificadorNiveles && p->posCola >= 0 && !ColaNiveles::admite(prioridad)) {
+        return ERROR_PRIORIDAD_FUERA_DE_RANGO;
+    }
+
+    indicePrioridad.eliminar(p->prioridad, pid);
+    indicePrioridad.insertar(prioridad, pid, p);
+    if (p->posCola >= 0 && planificadorNiveles) {
+        colaNiveles.quitarEn(p->posCola);
+        p->prioridad = prioridad;
+        colaNiveles.insertar(p);
+    } else {
+        p->prioridad = prioridad;
+        if (p->posCola >= 0) colaCPU.cambiarPrioridad(p->posCola, prioridad);
+    }
+    anotarOperacion(WAL_PRIORIDAD, 2, pid, prioridad, NULL, 0);
+    return OK;
+}
+
+// Saca de la cola el proceso de mayor prioridad (NULL si est vaca)
+Proceso* ejecutarSiguiente() {
+    MEDIR_OPERACION(OP_EJECUTAR);
+    Proceso* p = planificadorNiveles ? colaNiveles.extraer() // O(1)
+                                     : colaCPU.extraer(); // Saca la raz del montculo (O(log n))
+    if (p != NULL) anotarOperacion(WAL_DESENCOLAR, 0, 0, 0, NULL, 0);
+    return p;
+}
+
+// Asigna un bloque de memoria a un proceso (Push). En modo buddy el bloque
+// adems recibe un rango de direcciones del pool.
+Resultado reservarMemoria(int pid, int tamanio) {
+    MEDIR_OPERACION(OP_RESERVAR);
+    Proceso* p = buscarProcesoPorPID(pid);
+    if (p == NULL) return ERROR_NO_EXISTE;
+    if (tamanio <= 0) return ERROR_TAMANIO_INVALIDO;
+
+    int direccion = -1;
+    if (memoriaBuddy.activo()) {
+        direccion = memoriaBuddy.reservar(tamanio); // O(log N)
+        if (direccion < 0) return ERROR_SIN_MEMORIA;
+    }
+    apilarBloque(p, tamanio)->direccion = direccion;
+    anotarOperacion(WAL_RESERVAR, 2, pid, tamanio, NULL, 0);
+    return OK;
+}
+
+// Saca el bloque del tope (Pop) y lo devuelve ya desenlazado, o NULL si la
+// pila est vaca. El llamador lo usa para informar y luego lo devuelve
+// a poolBloques.
+BloqueMemoria* liberarTope() {
+    MEDIR_OPERACION(OP_LIBERAR);
+    if (topeMemoria == NULL) return NULL;
+
+    BloqueMemoria* temp = topeMemoria; // Guardar el bloque superior
+    desapilarBloque(temp); // Mueve el tope al siguiente y lo quita de su proceso
+    anotarOperacion(WAL_LIBERAR, 0, 0, 0, NULL, 0);
+    return temp;
+}
+
+// --- VISTAS (COMPLETAS, POR PGINAS O EN JSON) ---
+// Con millones de procesos imprimir todo tarda minutos, as que cada vista
+// se puede pedir por tramos: los procesos desde un PID (cursor), los
+// primeros K de la cola en orden de ejecucin y los ltimos K bloques
+// apilados. Cada tramo cuesta O(K) (O(K log K) en el montculo), no O(n).
+
+// Qu parte de una vista mostrar
+struct Pagina {
+    int limite;  // Cuntos elementos (0 = todos)
+    int despues; // Solo procesos: seguir despus de este PID (0 = desde el principio)
+    bool json;   // Una lnea JSON en lugar del texto
+
+    Pagina() {
+        limite = 0;
+        despues = 0;
+        json = false;
+    }
+};
+
+// Texto entre comillas con los escapes de JSON (los bytes >= 0x80 van tal cual)
+void imprimirTextoJSON(const char* s, unsigned n) {
+    static const char hex[] = "0123456789abcdef";
+    cout << '"';
+    for (unsigned i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\') cout << '\\' << (char)c;
+        else if (c < 0x20) cout << "\\u00" << hex[c >> 4] << hex[c & 15];
+        else cout << (char)c;
+    }
+    cout << '"';
+}
+
+void imprimirNombreJSON(const Proceso* p) {
+    imprimirTextoJSON(tablaNombres.texto(p->nombre), tablaNombres.largoDe(p->nombre));
+}
+
+// Imprime hasta 'limite' procesos de la lista desde 'p' (0 = todos) y
+// devuelve el siguiente sin mostrar (NULL si no quedan)
+Proceso* imprimirTramoProcesos(Proceso* p, int limite) {
+    for (int k = 0; p != NULL && (limite == 0 || k < limite); k++, p = p->siguiente) {
+        cout << "PID: " << p->pid
+             << ", Nombre: " << nombreDe(p)
+             << ", Prioridad: " << p->prioridad << "\n";
+    }
+    return p;
+}
+
+// Primer proceso de la pgina. Precondicin: si hay cursor, el PID existe.
+Proceso* inicioPagina(const Pagina& pag) {
+    return pag.despues != 0 ? buscarProcesoPorPID(pag.despues)->siguiente : cabezaProcesos;
+}
+
+void imprimirProcesos(const Pagina& pag = Pagina()) {
+    Proceso* p = inicioPagina(pag);
+    if (pag.json) {
+        cout << "{\"vista\":\"procesos\",\"total\":" << registroProcesos.cantidad() << ",\"procesos\":[";
+        for (int k = 0; p != NULL && (pag.limite == 0 || k < pag.limite); k++, p = p->siguiente) {
+            cout << (k > 0 ? "," : "") << "{\"pid\":" << p->pid << ",\"nombre\":";
+            imprimirNombreJSON(p);
+            cout << ",\"prioridad\":" << p->prioridad
+                 << ",\"enCola\":" << (p->posCola >= 0 ? "true" : "false")
+                 << ",\"bloques\":" << p->bloquesMemoria << ",\"kb\":" << p->kbMemoria << "}";
+        }
+        // Cursor para pedir la pgina siguiente
+        cout << "],\"siguiente\":";
+        if (p != NULL) cout << p->anterior->pid;
+        else cout << "null";
+        cout << "}\n";
+        return;
+    }
+
+    cout << "\n--- Lista de Todos los Procesos ---\n";
+    if (cabezaProcesos == NULL) {
+        cout << "No hay procesos registrados.\n";
+        return;
+    }
+    Proceso* resto = imprimirTramoProcesos(p, pag.limite);
+    if (resto != NULL) {
+        cout << "... (siguen mas: show processes after " << resto->anterior->pid
+             << " limit " << pag.limite << ")\n";
+    }
+}
+
+// Procesos con prioridad en [minimo, maximo], en orden de (prioridad, PID),
+// ledos del ndice de prioridades: O(log n + K) en lugar de recorrer la lista
+typedef IndicePrioridad<Proceso*>::Cursor CursorPrioridad;
+
+// Primera entrada de la pgina. Precondicin: si hay cursor, el PID existe.
+CursorPrioridad inicioRango(int minimo, const Pagina& pag) {
+    if (pag.despues != 0) {
+        Proceso* p = buscarProcesoPorPID(pag.despues);
+        if (p->prioridad >= minimo) return indicePrioridad.despuesDe(p->prioridad, p->pid);
+    }
+    return indicePrioridad.desde(minimo);
+}
+
+bool quedanEnRango(const CursorPrioridad& c, int maximo) {
+    return c.valido() && c.clave().prioridad <= maximo;
+}
+
+// Imprime hasta 'limite' procesos del rango desde 'c' (0 = todos) y deja en
+// 'ultimo' el PID del ltimo impreso. Retorna false si ya no quedan.
+bool imprimirTramoRango(CursorPrioridad& c, int maximo, int limite, int& ultimo) {
+    for (int k = 0; quedanEnRango(c, maximo) && (limite == 0 || k < limite); k++, c.avanzar()) {
+        Proceso* p = c.valor();
+        ultimo = p->pid;
+        cout << "PID: " << p->pid
+             << ", Nombre: " << nombreDe(p)
+             << ", Prioridad: " << p->prioridad << "\n";
+    }
+    return quedanEnRango(c, maximo);
+}
+
+void imprimirRangoPrioridad(int minimo, int maximo, const Pagina& pag = Pagina()) {
+    CursorPrioridad c = inicioRango(minimo, pag);
+    long total = indicePrioridad.contar(minimo, maximo);
+    if (pag.json) {
+        cout << "{\"vista\":\"prioridad\",\"minimo\":" << minimo << ",\"maximo\":" << maximo
+             << ",\"total\":" << total << ",\"procesos\":[";
+        int ultimo = 0;
+        for (int k = 0; quedanEnRango(c, maximo) && (pag.limite == 0 || k < pag.limite); k++, c.avanzar()) {
+            Proceso* p = c.valor();
+            ultimo = p->pid;
+            cout << (k > 0 ? "," : "") << "{\"pid\":" << p->pid << ",\"nombre\":";
+            imprimirNombreJSON(p);
+            cout << ",\"prioridad\":" << p->prioridad << "}";
+        }
+        // Cursor para pedir la pgina siguiente
+        cout << "],\"siguiente\":";
+        if (quedanEnRango(c, maximo)) cout << ultimo;
+        else cout << "null";
+        cout << "}\n";
+        return;
+    }
+
+    cout << "\n--- Procesos con Prioridad entre " << minimo << " y " << maximo << " (" << total << ") ---\n";
+    if (total == 0) {
+        cout << "No hay procesos en ese rango.\n";
+        return;
+    }
+    int ultimo = 0;
+    if (imprimirTramoRango(c, maximo, pag.limite, ultimo)) {
+        cout << "... (siguen mas: show priority " << minimo << " " << maximo << " after " << ultimo
+             << " limit " << pag.limite << ")\n";
+    }
+}
+
+// Recorre la cola en orden de ejecucin sin modificarla ni ordenarla
+// entera. En el montculo el prximo es siempre el menor de una "frontera"
+// de casillas (al principio solo la raz; al salir una casilla entran sus
+// dos hijos), as que los primeros K cuestan O(K log K). En la cola por
+// niveles se siguen los bits de los niveles y sus FIFO: O(1) por proceso.
+struct RecorridoCola {
+    // Orden de std::push_heap/pop_heap: "a sale despus que b", para que
+    // el frente de la frontera sea la casilla que sale primero
+    struct CasillaDespues {
+        bool operator()(int a, int b) const {
+            return colaCPU.antes(colaCPU.nodos[b], colaCPU.nodos[a]);
+        }
+    };
+
+    vector<int> frontera; // Casillas del montculo
+    int nivel;            // Niveles: nivel y nodo actuales (-1 = pasar al siguiente nivel)
+    int nodo;
+
+    RecorridoCola() {
+        nivel = -1;
+        nodo = -1;
+        if (!planificadorNiveles && colaCPU.cantidad > 0) frontera.push_back(0);
+    }
+
+    // NULL al terminar
+    Proceso* siguiente() {
+        if (planificadorNiveles) {
+            if (nodo == -1) {
+                nivel = colaNiveles.nivelDesde(nivel + 1);
+                if (nivel < 0) {
+                    nivel = ColaNiveles::NIVELES; // Terminado
+                    return NULL;
+                }
+                nodo = colaNiveles.primero[nivel];
+            }
+            Proceso* p = colaNiveles.nodos[nodo].proceso;
+            nodo = colaNiveles.nodos[nodo].siguiente;
+            return p;
+        }
+        if (frontera.empty()) return NULL;
+        pop_heap(frontera.begin(), frontera.end(), CasillaDespues());
+        int i = frontera.back();
+        frontera.pop_back();
+        for (int h = 2 * i + 1; h <= 2 * i + 2 && h < colaCPU.cantidad; h++) {
+            frontera.push_back(h);
+            push_heap(frontera.begin(), frontera.end(), CasillaDespues());
+        }
+        return colaCPU.nodos[i].proceso;
+    }
+};
+
+int cantidadEnCola() {
+    return planificadorNiveles ? colaNiveles.cantidad : colaCPU.cantidad;
+}
+
+// Imprime los siguientes 'limite' procesos del recorrido (0 = todos),
+// numerados desde k + 1. Retorna false si ya no quedan.
+bool imprimirTramoCola(RecorridoCola& r, int limite, int& k) {
+    for (int n = 0; limite == 0 || n < limite; n++) {
+        Proceso* p = r.siguiente();
+        if (p == NULL) return false;
+        cout << ++k << ". PID: " << p->pid
+             << ", Nombre: " << nombreDe(p)
+             << ", Prioridad: " << p->prioridad;
+        if (!planificadorNiveles && colaCPU.envejecimiento != 0) {
+            cout << " (efectiva " << colaCPU.prioridadEfectiva(colaCPU.nodos[p->posCola]) << ")";
+        }
+        cout << "\n";
+    }
+    return k < cantidadEnCola();
+}
+
+void imprimirCola(const Pagina& pag = Pagina()) {
+    RecorridoCola r;
+    if (pag.json) {
+        cout << "{\"vista\":\"cola\",\"total\":" << cantidadEnCola() << ",\"procesos\":[";
+        Proceso* p;
+        for (int k = 0; (pag.limite == 0 || k < pag.limite) && (p = r.siguiente()) != NULL; k++) {
+            cout << (k > 0 ? "," : "") << "{\"pid\":" << p->pid << ",\"nombre\":";
+            imprimirNombreJSON(p);
+            cout << ",\"prioridad\":" << p->prioridad << "}";
+        }
+        cout << "]}\n";
+        return;
+    }
+
+    cout << "\n--- Cola de Planificacion (Orden de Ejecucion) ---\n";
+    if (cantidadEnCola() == 0) {
+        cout << "La cola esta vacia.\n";
+        return;
+    }
+    int k = 0;
+    if (imprimirTramoCola(r, pag.limite, k)) {
+        cout << "... (" << cantidadEnCola() - k << " procesos mas en la cola)\n";
+    }
+}
+
+// Resumen del pool buddy: espacio libre, mayor bloque y fragmentacin
+void imprimirEstadoBuddy(const AsignadorBuddy& m) {
+    cout << "\n--- Pool de Memoria (buddy) ---\n"
+         << "Pool: " << m.unidades << " KB, libres: " << m.kbLibres << " KB"
+         << ", bloques asignados: " << m.bloquesVivos << "\n"
+         << "Mayor bloque libre: " << m.mayorLibre() << " KB\n"
+         << "Fragmentacion externa: " << (int)(m.fragmentacion() * 10 + 0.5) / 10.0 << "%\n"
+         << "Desperdicio interno: " << (m.kbEntregados - m.kbPedidos) << " KB"
+         << " (redondeo a potencias de 2)\n";
+    if (m.fallos > 0) cout << "Pedidos rechazados: " << m.fallos << "\n";
+}
+
+// Imprime hasta 'limite' bloques desde 'b' hacia la base (0 = todos) y
+// devuelve el siguiente sin mostrar (NULL si no quedan)
+BloqueMemoria* imprimirTramoMemoria(BloqueMemoria* b, int limite) {
+    for (int k = 0; b != NULL && (limite == 0 || k < limite); k++, b = b->siguiente) {
+        cout << "  Proceso: " << nombreDe(b->proceso) << " (PID: " << b->proceso->pid << ")\n"
+             << "  Tamano: " << b->tamanio << " KB\n";
+        if (b->direccion >= 0) {
+            cout << "  Direccion: " << b->direccion << " KB (bloque de "
+                 << (1u << memoriaBuddy.ordenPara(b->tamanio)) << " KB)\n";
+        }
+        cout << "  ||\n"
+             << "  \\/\n";
+    }
+    return b;
+}
+
+// Los bloques se muestran desde el tope: con lmite, los ltimos K apilados
+void imprimirMemoria(const Pagina& pag = Pagina()) {
+    if (pag.json) {
+        cout << "{\"vista\":\"memoria\",\"total\":" << poolBloques.vivos << ",\"enUsoKB\":" << kbEnUso
+             << ",\"bloques\":[";
+        BloqueMemoria* b = topeMemoria;
+        for (int k = 0; b != NULL && (pag.limite == 0 || k < pag.limite); k++, b = b->siguiente) {
+            cout << (k > 0 ? "," : "") << "{\"pid\":" << b->proceso->pid << ",\"nombre\":";
+            imprimirNombreJSON(b->proceso);
+            cout << ",\"tamanio\":" << b->tamanio << ",\"direccion\":" << b->direccion << "}";
+        }
+        cout << "]";
+        if (memoriaBuddy.activo()) {
+            cout << ",\"buddy\":{\"totalKB\":" << memoriaBuddy.unidades
+                 << ",\"libresKB\":" << memoriaBuddy.kbLibres
+                 << ",\"mayorLibreKB\":" << memoriaBuddy.mayorLibre() << "}";
+        }
+        cout << "}\n";
+        return;
+    }
+
+    cout << "\n--- Estado Actual de la Pila de Memoria ---\n";
+    if (topeMemoria == NULL) {
+        cout << "Pila de memoria vacia. No hay memoria asignada.\n";
+    } else {
+        cout << "(Tope)\n";
+        BloqueMemoria* resto = imprimirTramoMemoria(topeMemoria, pag.limite);
+        if (resto == NULL) cout << "(Base)\n";
+        else cout << "  ... (" << poolBloques.vivos - pag.limite << " bloques mas hasta la base)\n";
+    }
+    if (memoriaBuddy.activo()) imprimirEstadoBuddy(memoriaBuddy);
+}
+
+// Imprime los siguientes 'limite' procesos del ndice de memoria (0 = todos),
+// numerados desde k + 1. Retorna false si ya no quedan.
+bool imprimirTramoConsumidores(CursorPrioridad& c, int limite, int& k) {
+    for (int n = 0; c.valido() && (limite == 0 || n < limite); n++, c.avanzar()) {
+        Proceso* p = c.valor();
+        cout << ++k << ". PID: " << p->pid
+             << ", Nombre: " << nombreDe(p)
+             << ", Memoria: " << p->kbMemoria << " KB (" << p->bloquesMemoria << " bloques)\n";
+    }
+    return c.valido();
+}
+
+// Los procesos con ms memoria, de mayor a menor (a igual memoria, por PID).
+// Salen en orden del ndice de memoria: O(log n + K), sin ordenar la pila.
+void imprimirMayoresConsumidores(const Pagina& pag = Pagina()) {
+    CursorPrioridad c = indiceMemoria.desde(numeric_limits<int>::min());
+    if (pag.json) {
+        cout << "{\"vista\":\"consumidores\",\"enUsoKB\":" << kbEnUso << ",\"bloques\":" << poolBloques.vivos
+             << ",\"total\":" << indiceMemoria.cantidad << ",\"procesos\":[";
+        for (int k = 0; c.valido() && (pag.limite == 0 || k < pag.limite); k++, c.avanzar()) {
+            Proceso* p = c.valor();
+            cout << (k > 0 ? "," : "") << "{\"pid\":" << p->pid << ",\"nombre\":";
+            imprimirNombreJSON(p);
+            cout << ",\"kb\":" << p->kbMemoria << ",\"bloques\":" << p->bloquesMemoria << "}";
+        }
+        cout << "]}\n";
+        return;
+    }
+
+    cout << "\n--- Mayores Consumidores de Memoria ---\n"
+         << "En uso: " << kbEnUso << " KB en " << poolBloques.vivos << " bloques\n";
+    if (indiceMemoria.cantidad == 0) {
+        cout << "Ningun proceso tiene memoria asignada.\n";
+        return;
+    }
+    int k = 0;
+    if (imprimirTramoConsumidores(c, pag.limite, k)) {
+        cout << "... (" << indiceMemoria.cantidad - k << " procesos mas con memoria)\n";
+    }
+}
+
+void imprimirContadoresPool(const char* nombre, long vivos, unsigned long long pedidos,
+                            unsigned long long devueltos, unsigned long long mallocs) {
+    cout << nombre << ": vivos " << vivos
+         << ", pedidos " << pedidos
+         << ", devueltos " << devueltos
+         << ", slabs (mallocs) " << mallocs << "\n";
+}
+
+template <typename T>
+void imprimirPool(const char* nombre, const PoolNodos<T>& pool) {
+    imprimirContadoresPool(nombre, pool.vivos, pool.pedidos, pool.devueltos, pool.mallocs);
+}
+
+// Memoria por proceso: lo reservado para guardar procesos y sus nombres,
+// dividido por la cantidad de procesos vivos
+void imprimirBytesPorProceso(unsigned long long bytes, long procesos, const TablaNombres& nombres) {
+    cout << "Nombres: " << nombres.distintos << " distintos, "
+         << nombres.bytesReservados() << " bytes\n";
+    if (procesos > 0) {
+        cout << "Bytes por proceso: " << (double)(bytes + nombres.bytesReservados()) / procesos << "\n";
+    }
+}
+
+// Contadores de los pools: si 'slabs' no crece, no hubo mallocs nuevos
+void imprimirPools() {
+    cout << "\n--- Pools de Nodos ---\n";
+    // Los procesos salen de los pools de los fragmentos del registro
+    long vivos;
+    unsigned long long pedidos, devueltos, mallocs;
+    registroProcesos.contadores(vivos, pedidos, devueltos, mallocs);
+    imprimirContadoresPool("Proceso", vivos, pedidos, devueltos, mallocs);
+    imprimirPool("BloqueMemoria", poolBloques);
+    if (planificadorNiveles) {
+        cout << "NodoNivel: arreglo de la cola por niveles, capacidad " << colaNiveles.capacidad << "\n";
+    } else {
+        cout << "NodoCola: arreglo del monticulo, capacidad " << colaCPU.capacidad << "\n";
+    }
+    unsigned long long bytes = mallocs * sizeof(PoolNodos<Proceso>::Slab)
+                             + registroProcesos.capacidad() * sizeof(TablaPID<Proceso*>::Entrada);
+    imprimirBytesPorProceso(bytes, vivos, tablaNombres);
+}
+
+
+// --- INSTANTNEAS (ARCHIVO BINARIO, SE CARGA CON MMAP) ---
+// Guardan la lista de procesos, el orden de la cola de CPU y la pila de
+// memoria (ver instantanea.h). Al cargar, el archivo se mapea en memoria y
+// se recorre una sola vez de principio a fin: no hay texto que interpretar,
+// el ndice y el arreglo de la cola se reservan de una vez y el montculo
+// se copia tal cual, sin volver a ordenarlo.
+
+// pocas de la instantnea cargada con --cargar: dicen qu parte de la
+// bitcora ya est incluida en ella (ver reproducirBitacora)
+struct DatosInstantanea {
+    unsigned long long epoca;
+    unsigned long long epocaWAL;
+    long long registrosWAL;
+};
+DatosInstantanea instantaneaCargada = { 0, 0, 0 };
+
+// Escribe primero en <ruta>.tmp y despus lo renombra: si el programa se
+// corta a mitad de camino, la instantnea anterior sigue entera. Con la
+// bitcora activa, la instantnea pasa a ser su nueva base y la bitcora
+// empieza vaca.
+// Retorna NULL si sali bien o el motivo del error.
+const char* guardarInstantanea(const char* ruta) {
+    MEDIR_OPERACION(OP_GUARDAR);
+    string temporal = string(ruta) + ".tmp";
+    FILE* f = fopen(temporal.c_str(), "wb");
+    if (f == NULL) return "no se pudo crear el archivo";
+    EscritorBinario w(f);
+
+    CabeceraInstantanea c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.magia, MAGIA_INSTANTANEA, sizeof(c.magia));
+    c.version = VERSION_INSTANTANEA;
+    c.marcaOrden = MARCA_ORDEN;
+    if (planificadorNiveles) c.banderas |= INST_COLA_NIVELES;
+    if (memoriaBuddy.activo()) {
+        c.banderas |= INST_BUDDY;
+        c.buddyKB = (int)memoriaBuddy.unidades;
+    }
+    c.llegadas = colaCPU.llegadas;
+    c.epoca = nuevaEpoca();
+    if (bitacora.activa()) {
+        c.epocaWAL = bitacora.epoca;
+        c.registrosWAL = bitacora.registros;
+    }
+    w.escribir(&c, sizeof(c)); // Se reescribe al final con los desplazamientos
+
+    // Procesos, en el orden de la lista. Cada nombre distinto recibe un
+    // ndice la primera vez que aparece.
+    vector<unsigned> indiceNombre(tablaNombres.proximoId, 0xFFFFFFFFu);
+    vector<unsigned> idsEnOrden;
+    c.desProcesos = w.escritos;
+    for (Proceso* p = cabezaProcesos; p != NULL; p = p->siguiente) {
+        if (indiceNombre[p->nombre] == 0xFFFFFFFFu) {
+            indiceNombre[p->nombre] = (unsigned)idsEnOrden.size();
+            idsEnOrden.push_back(p->nombre);
+        }
+        RegistroProceso r;
+        r.pid = p->pid;
+        r.prioridad = p->prioridad;
+        r.nombre = indiceNombre[p->nombre];
+        r.relleno = 0;
+        w.escribir(&r, sizeof(r));
+        c.procesos++;
+    }
+
+    w.alinear();
+    c.desNombres = w.escritos;
+    c.nombres = (long long)idsEnOrden.size();
+    unsigned texto = 0;
+    for (size_t i = 0; i < idsEnOrden.size(); i++) {
+        RegistroNombre r;
+        r.inicio = texto;
+        r.largo = tablaNombres.largoDe(idsEnOrden[i]);
+        w.escribir(&r, sizeof(r));
+        texto += r.largo;
+    }
+
+    // Cola: el arreglo del montculo tal cual, o los niveles en orden de salida
+    w.alinear();
+    c.desCola = w.escritos;
+    if (planificadorNiveles) {
+        for (int nivel = 0; nivel < ColaNiveles::NIVELES; nivel++) {
+            for (int i = colaNiveles.primero[nivel]; i != -1; i = colaNiveles.nodos[i].siguiente) {
+                RegistroCola r;
+                r.pid = colaNiveles.nodos[i].proceso->pid;
+                r.prioridad = nivel + 1;
+                r.orden = (unsigned long long)c.enCola;
+                w.escribir(&r, sizeof(r));
+                c.enCola++;
+            }
+        }
+    } else {
+        for (int i = 0; i < colaCPU.cantidad; i++) {
+            RegistroCola r;
+            r.pid = colaCPU.nodos[i].proceso->pid;
+            r.prioridad = colaCPU.nodos[i].prioridad;
+            r.orden = colaCPU.nodos[i].orden;
+            w.escribir(&r, sizeof(r));
+        }
+        c.enCola = colaCPU.cantidad;
+    }
+
+    // Pila: de la base al tope, para volver a apilar en el mismo orden
+    w.alinear();
+    c.desBloques = w.escritos;
+    BloqueMemoria* base = topeMemoria;
+    while (base != NULL && base->siguiente != NULL) base = base->siguiente;
+    for (BloqueMemoria* b = base; b != NULL; b = b->anterior) {
+        RegistroBloque r;
+        r.pid = b->proceso->pid;
+        r.tamanio = b->tamanio;
+        r.direccion = b->direccion;
+        r.relleno = 0;
+        w.escribir(&r, sizeof(r));
+        c.bloques++;
+    }
+
+    w.alinear();
+    c.desLibres = w.escritos;
+    if (memoriaBuddy.activo()) {
+        for (int k = 0; k <= memoriaBuddy.ordenMaximo; k++) {
+            for (int d = memoriaBuddy.primeroLibre[k]; d != -1; d = memoriaBuddy.sigLibre[d]) {
+                RegistroLibre r;
+                r.direccion = d;
+                r.orden = k;
+                w.escribir(&r, sizeof(r));
+                c.libres++;
+            }
+        }
+    }
+
+    w.alinear();
+    c.desTexto = w.escritos;
+    c.bytesTexto = texto;
+    for (size_t i = 0; i < idsEnOrden.size(); i++) {
+        w.escribir(tablaNombres.texto(idsEnOrden[i]), tablaNombres.largoDe(idsEnOrden[i]));
+    }
+    c.tamanioArchivo = w.escritos;
+    w.vaciar();
+
+    bool ok = w.ok && fseek(f, 0, SEEK_SET) == 0 && fwrite(&c, sizeof(c), 1, f) == 1;
+    // Antes de vaciar la bitcora la instantnea tiene que estar en el disco
+    if (bitacora.activa()) ok = ok && sincronizarArchivo(f);
+    ok = fclose(f) == 0 && ok;
+    if (!ok) {
+        remove(temporal.c_str());
+        return "no se pudo escribir el archivo";
+    }
+    // Si falla no se vaca la bitcora: sirve tanto con la instantnea vieja
+    // como con la nueva (que anota cuntos registros ya incluye)
+    if (!reemplazarArchivo(temporal.c_str(), ruta, bitacora.activa())) return "no se pudo reemplazar el archivo";
+    if (!bitacora.reiniciar(c.epoca)) {
+        bitacora.cerrar();
+        return "se guardo, pero no se pudo reiniciar la bitacora (quedo desactivada)";
+    }
+    return NULL;
+}
+
+// Orden de salida de la cola: por prioridad y, a igual prioridad, por llegada
+bool registroAntes(const RegistroCola& x, const RegistroCola& y) {
+    return x.prioridad != y.prioridad ? x.prioridad < y.prioridad : x.orden < y.orden;
+}
+
+// Carga una instantnea en el gestor vaco (se usa al arrancar, con
+// --cargar). El modo de memoria sale del archivo: si tiene direcciones, se
+// arma el pool buddy del mismo tamao. Retorna NULL si sali bien o el
+// motivo del error; si falla a mitad de camino el estado queda incompleto
+// y el programa no sigue.
+const char* cargarInstantanea(const char* ruta) {
+    if (cabezaProcesos != NULL || topeMemoria != NULL) return "el gestor no esta vacio";
+    ArchivoMapeado a;
+    if (!a.abrir(ruta)) return "no se pudo abrir el archivo";
+    const char* error = validarCabecera(a);
+    if (error != NULL) return error;
+    const CabeceraInstantanea& c = *(const CabeceraInstantanea*)a.datos;
+    instantaneaCargada.epoca = c.epoca;
+    instantaneaCargada.epocaWAL = c.epocaWAL;
+    instantaneaCargada.registrosWAL = c.registrosWAL;
+
+    if (c.banderas & INST_BUDDY) {
+        if (memoriaBuddy.activo() && (int)memoriaBuddy.unidades != c.buddyKB) {
+            return "el pool buddy del archivo no es del tamano pedido con --buddy";
+        }
+        if (!memoriaBuddy.iniciar(c.buddyKB)) return "tamano de pool buddy invalido";
+    } else if (memoriaBuddy.activo()) {
+        return "el archivo se guardo sin pool buddy";
+    }
+
+    // Nombres: se internan una vez cada uno; cada proceso suma una referencia
+    const RegistroNombre* nombres = (const RegistroNombre*)(a.datos + c.desNombres);
+    const char* texto = a.datos + c.desTexto;
+    vector<unsigned> ids(c.nombres);
+    for (long long i = 0; i < c.nombres; i++) {
+        if (nombres[i].largo == 0 || nombres[i].inicio > c.bytesTexto
+            || nombres[i].largo > c.bytesTexto - nombres[i].inicio) {
+            return "nombre fuera del texto";
+        }
+        ids[i] = tablaNombres.internar(texto + nombres[i].inicio, nombres[i].largo);
+    }
+
+    // Las casillas del ndice se piden a memoria ADELANTO registros antes
+    const long long ADELANTO = 16;
+    const RegistroProceso* procesos = (const RegistroProceso*)(a.datos + c.desProcesos);
+    registroProcesos.reservar((unsigned)c.procesos);
+    for (long long i = 0; i < c.procesos; i++) {
+        const RegistroProceso& r = procesos[i];
+        if (i + ADELANTO < c.procesos) registroProcesos.precargar(procesos[i + ADELANTO].pid);
+        if (r.pid <= 0 || r.prioridad <= 0 || r.nombre >= (unsigned long long)c.nombres) return "proceso invalido";
+        // Un solo hilo: el registro se llena sin tomar los cerrojos
+        Proceso* p = registroProcesos.alta(r.pid);
+        if (p == NULL) return "PID repetido";
+        p->pid = r.pid;
+        p->nombre = ids[r.nombre];
+        p->prioridad = r.prioridad;
+        p->posCola = -1;
+        p->bloquesMemoria = 0;
+        p->kbMemoria = 0;
+        p->bloques = NULL;
+        tablaNombres.retener(p->nombre);
+        indicePrioridad.insertar(p->prioridad, p->pid, p);
+        enlazarProceso(p);
+    }
+    for (long long i = 0; i < c.nombres; i++) tablaNombres.soltar(ids[i]); // La referencia de internar
+
+    // Cola. Una lista en orden de salida tambin es un montculo vlido, as
+    // que en los dos sentidos alcanza con copiar, salvo de montculo a niveles
+    // (hay que ordenar por prioridad y llegada).
+    const RegistroCola* cola = (const RegistroCola*)(a.datos + c.desCola);
+    vector<RegistroCola> ordenada;
+    if (planificadorNiveles && !(c.banderas & INST_COLA_NIVELES)) {
+        ordenada.assign(cola, cola + c.enCola);
+        sort(ordenada.begin(), ordenada.end(), registroAntes);
+        cola = ordenada.empty() ? cola : &ordenada[0];
+    }
+    if (!planificadorNiveles) colaCPU.reservar((int)c.enCola);
+    for (long long i = 0; i < c.enCola; i++) {
+        if (i + ADELANTO < c.enCola) registroProcesos.precargar(cola[i + ADELANTO].pid);
+        Proceso* p = buscarProcesoPorPID(cola[i].pid);
+        if (p == NULL || p->posCola >= 0 || cola[i].prioridad != p->prioridad) return "cola invalida";
+        if (planificadorNiveles) {
+            if (!ColaNiveles::admite(p->prioridad)) return mensajeError(ERROR_PRIORIDAD_FUERA_DE_RANGO);
+            colaNiveles.insertar(p);
+        } else {
+            colaCPU.agregarAlFinal(p, cola[i].prioridad, cola[i].orden);
+        }
+    }
+    if (!planificadorNiveles) {
+        // Guardada con otro --envejecimiento, el orden del montculo es otro
+        if (!colaCPU.esMonticulo()) colaCPU.armarMonticulo();
+        colaCPU.llegadas = (c.banderas & INST_COLA_NIVELES) ? (unsigned long long)c.enCola : c.llegadas;
+    }
+
+    const RegistroBloque* bloques = (const RegistroBloque*)(a.datos + c.desBloques);
+    for (long long i = 0; i < c.bloques; i++) {
+        const RegistroBloque& r = bloques[i];
+        if (i + ADELANTO < c.bloques) registroProcesos.precargar(bloques[i + ADELANTO].pid);
+        Proceso* p = buscarProcesoPorPID(r.pid);
+        if (p == NULL || r.tamanio <= 0) return "bloque de memoria invalido";
+        if (memoriaBuddy.activo() ? !memoriaBuddy.reservarEn(r.direccion, r.tamanio) : r.direccion != -1) {
+            return "direccion de memoria invalida";
+        }
+        apilarBloque(p, r.tamanio)->direccion = r.direccion;
+    }
+
+    // Los bloques libres ya son los mismos; falta dejar cada lista en su orden
+    const RegistroLibre* libres = (const RegistroLibre*)(a.datos + c.desLibres);
+    if (c.libres > 0 && !memoriaBuddy.activo()) return "bloques libres sin pool buddy";
+    vector<int> dirs;
+    for (long long i = 0; i < c.libres;) {
+        int k = libres[i].orden;
+        dirs.clear();
+        for (; i < c.libres && libres[i].orden == k; i++) dirs.push_back(libres[i].direccion);
+        if (!memoriaBuddy.reordenarLibres(k, &dirs[0], (int)dirs.size())) return "pool buddy inconsistente";
+    }
+    if (memoriaBuddy.activo()) {
+        long long totalLibres = 0;
+        for (int k = 0; k <= memoriaBuddy.ordenMaximo; k++) totalLibres += memoriaBuddy.libresPorOrden[k];
+        if (totalLibres != c.libres) return "pool buddy inconsistente";
+    }
+    return NULL;
+}
+
+
+
+// --- BITCORA DE ESCRITURA ANTICIPADA (--wal) ---
+// Al arrancar se reproducen, con las mismas operaciones base, los registros
+// que la instantnea cargada todava no incluye; despus la bitcora queda
+// abierta para seguir anotando al final.
+
+// Aplica un registro. false si no tiene sentido en el estado actual.
+bool aplicarRegistro(const LectorBitacora& l) {
+    switch (l.tipo) {
+        case WAL_CREAR:
+            if (l.largo < 8) return false;
+            return crearProceso(l.entero(0), string(l.contenido + 8, l.largo - 8), l.entero(1)) == OK;
+        case WAL_BORRAR:
+            return l.largo == 4 && borrarProceso(l.entero(0), NULL, NULL) == OK;
+        case WAL_ENCOLAR:
+            return l.largo == 4 && encolarProceso(l.entero(0)) == OK;
+        case WAL_DESENCOLAR:
+            return l.largo == 0 && ejecutarSiguiente() != NULL;
+        case WAL_RESERVAR:
+            return l.largo == 8 && reservarMemoria(l.entero(0), l.entero(1)) == OK;
+        case WAL_PRIORIDAD:
+            return l.largo == 8 && cambiarPrioridad(l.entero(0), l.entero(1)) == OK;
+        case WAL_LIBERAR: {
+            if (l.largo != 0) return false;
+            BloqueMemoria* b = liberarTope();
+            if (b == NULL) return false;
+            poolBloques.devolver(b);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reproduce la bitcora (si existe) sobre el estado actual y la deja
+// abierta. 'aplicados' recibe la cantidad de registros reproducidos.
+// Retorna NULL si sali bien o el motivo del error.
+const char* reproducirBitacora(const char* ruta, long long& aplicados) {
+    aplicados = 0;
+    long long validos = 0; // 0 = crear el archivo con una cabecera nueva
+    long long registros = 0;
+    unsigned long long epoca = nuevaEpoca();
+    unsigned long long base = instantaneaCargada.epoca;
+
+    ArchivoMapeado a;
+    // Ms corto que la cabecera: se cort al crearlo, no tiene registros
+    if (a.abrir(ruta) && a.tamanio >= (long long)sizeof(CabeceraBitacora)) {
+        const CabeceraBitacora& c = *(const CabeceraBitacora*)a.datos;
+        if (memcmp(c.magia, MAGIA_BITACORA, sizeof(c.magia)) != 0) return "no es una bitacora del gestor";
+        if (c.marcaOrden != MARCA_ORDEN) return "el archivo es de una maquina con otro orden de bytes";
+        // Cada desencolar depende del orden de la cola: con otro E saldran otros procesos
+        if (c.envejecimiento != bitacora.envejecimiento) return "la bitacora se escribio con otro --envejecimiento";
+        if (c.niveles != bitacora.niveles) return "la bitacora se escribio con otro --planificador";
+        // Con otro pool (o sin l) las reservas anotadas podran no entrar
+        if (c.buddyKB != bitacora.buddyKB) return "la bitacora se escribio con otro --buddy";
+
+        // Si la instantnea se guard con esta misma bitcora activa, sus
+        // primeros registros ya estn incluidos; si la bitcora empez
+        // sobre esta instantnea (o sobre el estado vaco), van todos.
+        long long yaIncluidos;
+        if (instantaneaCargada.epocaWAL == c.epoca) yaIncluidos = instantaneaCargada.registrosWAL;
+        else if (instantaneaCargada.epoca == c.epocaBase) yaIncluidos = 0;
+        else return "la bitacora no corresponde a la instantanea cargada";
+
+        LectorBitacora l(a.datos, a.tamanio);
+        while (l.siguiente()) {
+            registros++;
+            if (registros <= yaIncluidos) continue;
+            if (!aplicarRegistro(l)) return "un registro no se pudo aplicar";
+            aplicados++;
+        }
+        validos = l.pos; // Lo que sigue qued a medio escribir: se descarta
+        epoca = c.epoca;
+        base = c.epocaBase;
+    }
+    a.cerrar();
+
+    if (!bitacora.abrir(ruta, validos, epoca, base, registros)) return "no se pudo abrir el archivo";
+    return NULL;
+}
+
+// --- IMPORTACIN MASIVA (CSV / JSONL, SE LEE CON MMAP) ---
+// Crea procesos en bloque desde un archivo de texto, una fila por proceso:
+//
+//   CSV:   pid,nombre,prioridad[,tiempoCPU[,bloques]]
+//          (bloques: tamaos en KB separados por ';'; el nombre puede ir
+//          entre comillas, con "" para una comilla; una primera lnea que
+//          empieza con "pid" se toma como encabezado)
+//   JSONL: {"pid": 1, "nombre": "x", "prioridad": 3, "tiempoCPU": 10, "bloques": [4, 8]}
+//
+// Si el primer carcter no blanco del archivo es '{' se lee como JSONL.
+// Cada proceso entra a la lista, al ndice y a la cola de CPU, y sus
+// bloques se apilan en el orden del archivo. El gestor no guarda el tiempo
+// de CPU: se valida y se descarta.
+//
+// El archivo se recorre una sola vez sobre el mapeo en memoria: los campos
+// se leen como punteros al texto (no se arma un string por campo) y los
+// nombres se internan directo desde ah. Las filas van al final del arreglo
+// del montculo y al terminar se ordena todo de una vez en O(n).
+
+// Lee un entero decimal (con signo opcional) que termina en 'fin' o en un
+// carcter que no es dgito. false si no hay dgitos o no entra en un int.
+bool leerEnteroTexto(const char*& p, const char* fin, int& valor) {
+    bool negativo = p < fin && *p == '-';
+    if (negativo) p++;
+    if (p == fin || *p < '0' || *p > '9') return false;
+    long long v = 0;
+    while (p < fin && *p >= '0' && *p <= '9') {
+        v = v * 10 + (*p++ - '0');
+        if (v > 0x7fffffffLL) return false;
+    }
+    valor = negativo ? (int)-v : (int)v;
+    return true;
+}
+
+void saltarBlancos(const char*& p, const char* fin) {
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+}
+
+// Una fila ya separada en campos. El nombre apunta al archivo mapeado o,
+// si tena escapes, a 'copia'.
+struct FilaImportada {
+    int pid;
+    int prioridad;
+    int tiempoCPU; // 0 si no vino
+    const char* nombre;
+    unsigned largoNombre;
+    string copia;
+    vector<int> bloques;
+};
+
+// Fila CSV entre p y fin (sin el salto de lnea)
+const char* leerFilaCSV(const char* p, const char* fin, FilaImportada& f) {
+    if (!leerEnteroTexto(p, fin, f.pid)) return "pid invalido";
+    if (p == fin || *p++ != ',') return "faltan campos (pid,nombre,prioridad)";
+
+    if (p < fin && *p == '"') {
+        const char* inicio = ++p;
+        bool conEscapes = false;
+        while (true) {
+            if (p == fin) return "falta cerrar las comillas del nombre";
+            if (*p == '"') {
+                if (p + 1 < fin && p[1] == '"') {
+                    conEscapes = true;
+                    p += 2;
+                    continue;
+                }
+                break;
+            }
+            p++;
+        }
+        f.nombre = inicio;
+        f.largoNombre = (unsigned)(p - inicio);
+        p++; // Comilla de cierre
+        if (conEscapes) {
+            f.copia.clear();
+            for (const char* q = inicio; q < inicio + f.largoNombre; q++) {
+                f.copia += *q;
+                if (*q == '"') q++; // "" -> "
+            }
+            f.nombre = f.copia.data();
+            f.largoNombre = (unsigned)f.copia.size();
+        }
+    } else {
+        const char* inicio = p;
+        while (p < fin && *p != ',') p++;
+        f.nombre = inicio;
+        f.largoNombre = (unsigned)(p - inicio);
+    }
+    if (p == fin || *p++ != ',') return "faltan campos (pid,nombre,prioridad)";
+
+    if (!leerEnteroTexto(p, fin, f.prioridad)) return "prioridad invalida";
+    if (p < fin && *p == ',') {
+        p++;
+        if (p < fin && *p != ',' && !leerEnteroTexto(p, fin, f.tiempoCPU)) return "tiempoCPU invalido";
+        if (p < fin && *p == ',') {
+            p++;
+            while (p < fin) {
+                int kb;
+                if (!leerEnteroTexto(p, fin, kb)) return "tamano de bloque invalido";
+                f.bloques.push_back(kb);
+                if (p < fin && *p == ';') p++;
+                else break;
+            }
+        }
+    }
+    saltarBlancos(p, fin);
+    return p == fin ? NULL : "sobran caracteres al final de la fila";
+}
+
+// Cadena JSON (p apunta a la comilla de apertura). Si no tiene escapes queda
+// apuntando al archivo; si los tiene se decodifica en 'copia'.
+bool leerCadenaJSON(const char*& p, const char* fin, const char*& inicio, unsigned& largo, string& copia) {
+    inicio = ++p;
+    while (p < fin && *p != '"' && *p != '\\') p++;
+    if (p < fin && *p == '"') {
+        largo = (unsigned)(p - inicio);
+        p++;
+        return true;
+    }
+    copia.assign(inicio, p);
+    while (p < fin && *p != '"') {
+        if (*p != '\\') {
+            copia += *p++;
+            continue;
+        }
+        if (++p == fin) return false;
+        char e = *p++;
+        switch (e) {
+            case '"': case '\\': case '/': copia += e; break;
+            case 'b': copia += '\b'; break;
+            case 'f': copia += '\f'; break;
+            case 'n': copia += '\n'; break;
+            case 'r': copia += '\r'; break;
+            case 't': copia += '\t'; break;
+            case 'u': {
+                if (fin - p < 4) return false;
+                unsigned c = 0;
+                for (int i = 0; i < 4; i++, p++) {
+                    char h = *p;
+                    unsigned d;
+                    if (h >= '0' && h <= '9') d = h - '0';
+                    else if (h >= 'a' && h <= 'f') d = h - 'a' + 10;
+                    else if (h >= 'A' && h <= 'F') d = h - 'A' + 10;
+                    else return false; // Dgito hexadecimal invlido
+                    c = c * 16 + d;
+                }
+                // A UTF-8 (los pares sustitutos quedan como dos caracteres)
+                if (c < 0x80) {
+                    copia += (char)c;
+                } else if (c < 0x800) {
+                    copia += (char)(0xC0 | (c >> 6));
+                    copia += (char)(0x80 | (c & 0x3F));
+                } else {
+                    copia += (char)(0xE0 | (c >> 12));
+                    copia += (char)(0x80 | ((c >> 6) & 0x3F));
+                    copia += (char)(0x80 | (c & 0x3F));
+                }
+                break;
+            }
+            default: return false;
+        }
+    }
+    if (p == fin) return false;
+    p++;
+    inicio = copia.data();
+    largo = (unsigned)copia.size();
+    return true;
+}
+
+// Salta un valor JSON de una clave que no se usa
+bool saltarValorJSON(const char*& p, const char* fin) {
+    int profundidad = 0;
+    string basura;
+    do {
+        saltarBlancos(p, fin);
+        if (p == fin) return false;
+        if (*p == '"') {
+            const char* inicio;
+            unsigned largo;
+            if (!leerCadenaJSON(p, fin, inicio, largo, basura)) return false;
+        } else if (*p == '{' || *p == '[') {
+            profundidad++;
+            p++;
+        } else if (*p == '}' || *p == ']') {
+            if (--profundidad < 0) return false;
+            p++;
+        } else if (*p == ',' || *p == ':') {
+            if (profundidad == 0) return false;
+            p++;
+        } else {
+            while (p < fin && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t') p++;
+        }
+    } while (profundidad > 0);
+    return true;
+}
+
+bool claveEs(const char* clave, unsigned largo, const char* buscada) {
+    return largo == strlen(buscada) && memcmp(clave, buscada, largo) == 0;
+}
+
+// Fila JSONL (un objeto) entre p y fin
+const char* leerFilaJSON(const char* p, const char* fin, FilaImportada& f) {
+    bool hayPid = false, hayNombre = false, hayPrioridad = false;
+    saltarBlancos(p, fin);
+    if (p == fin || *p++ != '{') return "se esperaba '{'";
+    saltarBlancos(p, fin);
+    if (p < fin && *p == '}') return "objeto vacio";
+    while (true) {
+        saltarBlancos(p, fin);
+        const char* clave;
+        unsigned largoClave;
+        string copiaClave;
+        if (p == fin || *p != '"' || !leerCadenaJSON(p, fin, clave, largoClave, copiaClave)) {
+            return "se esperaba una clave entre comillas";
+        }
+        saltarBlancos(p, fin);
+        if (p == fin || *p++ != ':') return "se esperaba ':'";
+        saltarBlancos(p, fin);
+
+        if (claveEs(clave, largoClave, "pid")) {
+            if (!leerEnteroTexto(p, fin, f.pid)) return "pid invalido";
+            hayPid = true;
+        } else if (claveEs(clave, largoClave, "prioridad")) {
+            if (!leerEnteroTexto(p, fin, f.prioridad)) return "prioridad invalida";
+            hayPrioridad = true;
+        } else if (claveEs(clave, largoClave, "tiempoCPU")) {
+            if (!leerEnteroTexto(p, fin, f.tiempoCPU)) return "tiempoCPU invalido";
+        } else if (claveEs(clave, largoClave, "nombre")) {
+            if (p == fin || *p != '"' || !leerCadenaJSON(p, fin, f.nombre, f.largoNombre, f.copia)) {
+                return "nombre invalido";
+            }
+            hayNombre = true;
+        } else if (claveEs(clave, largoClave, "bloques")) {
+            if (p == fin || *p++ != '[') return "bloques debe ser una lista";
+            saltarBlancos(p, fin);
+            if (p < fin && *p == ']') {
+                p++;
+            } else {
+                while (true) {
+                    int kb;
+                    saltarBlancos(p, fin);
+                    if (!leerEnteroTexto(p, fin, kb)) return "tamano de bloque invalido";
+                    f.bloques.push_back(kb);
+                    saltarBlancos(p, fin);
+                    if (p < fin && *p == ',') p++;
+                    else if (p < fin && *p == ']') break;
+                    else return "se esperaba ',' o ']' en bloques";
+                }
+                p++;
+            }
+        } else if (!saltarValorJSON(p, fin)) {
+            return "valor invalido";
+        }
 
-/**
- * (NUEVO) Elimina todas las entradas de un PID de la Pila de Memoria.
- * Esto es necesario para evitar punteros colgantes cuando se borra un Proceso.
- */
-void eliminarProcesosDePila(int pid) {
-    if (topeMemoria == NULL) return;
-
-    BloqueMemoria* actual = topeMemoria;
-    BloqueMemoria* prev = NULL;
-
-    // Bucle para eliminar todos los bloques que coincidan en el TOPE
-    while (actual != NULL && actual->proceso->pid == pid) {
-        BloqueMemoria* temp = actual;
-        actual = actual->siguiente;
-        topeMemoria = actual; // Mover el tope
-        delete temp;
-        cout << "  -> Bloque de memoria (PID: " << pid << ") liberado de la Pila.\n";
-    }
-
-    // Si la pila se vaci, salir
-    if (actual == NULL) return;
-
-    // Recorrer el resto de la pila
-    prev = actual;
-    actual = actual->siguiente;
-
-    while (actual != NULL) {
-        if (actual->proceso->pid == pid) {
-            // Eliminar 'actual'
-            BloqueMemoria* temp = actual;
-            prev->siguiente = actual->siguiente; // Enlazar el anterior con el siguiente
-            actual = actual->siguiente; // Mover 'actual'
-            delete temp;
-            cout << "  -> Bloque de memoria (PID: " << pid << ") liberado de la Pila.\n";
+        saltarBlancos(p, fin);
+        if (p < fin && *p == ',') {
+            p++;
+        } else if (p < fin && *p == '}') {
+            p++;
+            break;
         } else {
-            // Avanzar ambos
-            prev = actual;
-            actual = actual->siguiente;
+            return "se esperaba ',' o '}'";
         }
     }
+    saltarBlancos(p, fin);
+    if (p != fin) return "sobran caracteres despues del objeto";
+    if (!hayPid || !hayNombre || !hayPrioridad) return "faltan pid, nombre o prioridad";
+    return NULL;
 }
 
-/**
- * (NUEVO) Elimina la entrada de un PID de la Cola del Planificador.
- */
-void eliminarProcesoDeCola(int pid) {
-    if (cabezaCola == NULL) return;
-
-    NodoCola* temp = NULL;
-    // Caso 1: El nodo a eliminar es la cabeza
-    if (cabezaCola->proceso->pid == pid) {
-        temp = cabezaCola;
-        cabezaCola = cabezaCola->siguiente;
-        delete temp;
-        cout << "  -> Proceso (PID: " << pid << ") eliminado de la Cola de CPU.\n";
-        return; // Un proceso solo puede estar una vez en la cola
-    }
-    
-    // Caso 2: El nodo est en otra parte
-    NodoCola* actual = cabezaCola;
-    while (actual->siguiente != NULL && actual->siguiente->proceso->pid != pid) {
-        actual = actual->siguiente;
+// Da de alta el proceso de una fila ya leda, con su lugar en la cola (al
+// final del arreglo del montculo, sin reordenar) y sus bloques
+const char* altaImportada(const FilaImportada& f) {
+    if (f.pid <= 0) return mensajeError(ERROR_PID_INVALIDO);
+    if (f.largoNombre == 0) return mensajeError(ERROR_NOMBRE_VACIO);
+    // Un \u0000 cortara el nombre al imprimirlo como cadena de C
+    if (memchr(f.nombre, '\0', f.largoNombre) != NULL) return "El nombre no puede contener el caracter nulo.";
+    if (f.prioridad <= 0) return mensajeError(ERROR_PRIORIDAD_INVALIDA);
+    if (f.tiempoCPU < 0) return "El tiempo de CPU no puede ser negativo.";
+    if (planificadorNiveles && !ColaNiveles::admite(f.prioridad)) return mensajeError(ERROR_PRIORIDAD_FUERA_DE_RANGO);
+    for (size_t i = 0; i < f.bloques.size(); i++) {
+        if (f.bloques[i] <= 0) return mensajeError(ERROR_TAMANIO_INVALIDO);
     }
 
-    // Si se encontr
-    if (actual->siguiente != NULL) {
-        temp = actual->siguiente;
-        actual->siguiente = temp->siguiente;
-        delete temp;
-        cout << "  -> Proceso (PID: " << pid << ") eliminado de la Cola de CPU.\n";
+    Proceso* p = registroProcesos.alta(f.pid);
+    if (p == NULL) return mensajeError(ERROR_PID_DUPLICADO);
+    p->pid = f.pid;
+    p->prioridad = f.prioridad;
+    p->posCola = -1;
+    p->bloquesMemoria = 0;
+    p->kbMemoria = 0;
+    p->bloques = NULL;
+    p->nombre = tablaNombres.internar(f.nombre, f.largoNombre);
+    indicePrioridad.insertar(p->prioridad, p->pid, p);
+    enlazarProceso(p);
+
+    if (planificadorNiveles) colaNiveles.insertar(p);
+    else colaCPU.agregarAlFinal(p, p->prioridad, colaCPU.llegadas++);
+
+    for (size_t i = 0; i < f.bloques.size(); i++) {
+        int direccion = -1;
+        if (memoriaBuddy.activo()) {
+            direccion = memoriaBuddy.reservar(f.bloques[i]);
+            if (direccion < 0) return mensajeError(ERROR_SIN_MEMORIA);
+        }
+        apilarBloque(p, f.bloques[i])->direccion = direccion;
     }
+    return NULL;
 }
 
-// --- (FIN DE LA CORRECCIN) ---
+// Importa el archivo sobre el estado actual (se usa al arrancar, con
+// --importar). Retorna NULL si sali bien o el motivo del error, con la
+// lnea en 'linea'; como con cargarInstantanea, si falla a mitad de camino
+// el estado queda incompleto y el programa no sigue. 'filas' recibe la
+// cantidad de procesos creados.
+const char* importarProcesos(const char* ruta, long long& linea, long long& filas) {
+    linea = 0;
+    filas = 0;
+    ArchivoMapeado a;
+    if (!a.abrir(ruta)) return "no se pudo abrir el archivo (o esta vacio)";
+    const char* p = a.datos;
+    const char* fin = a.datos + a.tamanio;
+
+    // Cada fila ocupa una lnea: contarlas (memchr es muy rpido) alcanza
+    // para reservar el ndice y el montculo de una vez
+    long long lineas = 1;
+    for (const char* q = p; (q = (const char*)memchr(q, '\n', (size_t)(fin - q))) != NULL; q++) lineas++;
+    long long yaRegistrados = registroProcesos.cantidad();
+    if (lineas + yaRegistrados > 0x7fffffffLL) return "demasiadas filas";
+    registroProcesos.reservar((unsigned)(yaRegistrados + lineas));
+    if (!planificadorNiveles) colaCPU.reservar(colaCPU.cantidad + (int)lineas);
+
+    const char* q = p;
+    saltarBlancos(q, fin);
+    while (q < fin && *q == '\n') {
+        q++;
+        saltarBlancos(q, fin);
+    }
+    bool json = q < fin && *q == '{';
+
+    FilaImportada f;
+    while (p < fin) {
+        const char* finLinea = (const char*)memchr(p, '\n', (size_t)(fin - p));
+        if (finLinea == NULL) finLinea = fin;
+        const char* sigLinea = finLinea < fin ? finLinea + 1 : fin;
+        if (finLinea > p && finLinea[-1] == '\r') finLinea--;
+        linea++;
+
+        const char* inicio = p;
+        saltarBlancos(inicio, finLinea);
+        p = sigLinea;
+        if (inicio == finLinea) continue; // Lnea vaca
+        if (!json && linea == 1 && finLinea - inicio >= 3 && memcmp(inicio, "pid", 3) == 0) continue; // Encabezado
+
+        f.tiempoCPU = 0;
+        f.bloques.clear();
+        const char* error = json ? leerFilaJSON(inicio, finLinea, f) : leerFilaCSV(inicio, finLinea, f);
+        if (error == NULL) error = altaImportada(f);
+        if (error != NULL) return error;
+        filas++;
+    }
 
+    if (!planificadorNiveles) colaCPU.armarMonticulo();
+    return NULL;
+}
 
 // --- GESTOR DE PROCESOS (LISTA ENLAZADA) ---
 
@@ -198,23 +1988,8 @@ void insertarProceso() {
         }
     } while (prioridad <= 0);
 
-    // Crear el nuevo proceso
-    Proceso* nuevo = new Proceso();
-    nuevo->pid = pid;
-    nuevo->nombre = nombre;
-    nuevo->prioridad = prioridad;
-    nuevo->siguiente = NULL;
-
-    // Insertar en la lista
-    if (cabezaProcesos == NULL) {
-        cabezaProcesos = nuevo; // Si la lista est vaca
-    } else {
-        Proceso* actual = cabezaProcesos;
-        while (actual->siguiente != NULL) {
-            actual = actual->siguiente;
-        }
-        actual->siguiente = nuevo; // Aadir al final
-    }
+    // Crear el nuevo proceso (los datos ya fueron validados)
+    crearProceso(pid, nombre, prioridad);
 
     cout << "Proceso insertado correctamente.\n";
     limpiarYPausar();
@@ -237,38 +2012,19 @@ void eliminarProceso() {
         return;
     }
 
-    Proceso* aEliminar = NULL;
+    if (buscarProcesoPorPID(pid) != NULL) {
+        cout << "Proceso (PID: " << pid << ") encontrado. Eliminando de todas las estructuras...\n";
+
+        int liberados = 0;
+        bool estabaEnCola = false;
+        borrarProceso(pid, &liberados, &estabaEnCola);
 
-    // 1. Buscar y desenlazar de la lista principal
-    // Caso 1: El nodo a eliminar es la cabeza
-    if (cabezaProcesos->pid == pid) {
-        aEliminar = cabezaProcesos;
-        cabezaProcesos = cabezaProcesos->siguiente;
-    } else {
-        // Caso 2: El nodo est en otra parte
-        Proceso* actual = cabezaProcesos;
-        while (actual->siguiente != NULL && actual->siguiente->pid != pid) {
-            actual = actual->siguiente;
+        for (int i = 0; i < liberados; i++) {
+            cout << "  -> Bloque de memoria (PID: " << pid << ") liberado de la Pila.\n";
         }
-        if (actual->siguiente != NULL) {
-            aEliminar = actual->siguiente;
-            actual->siguiente = aEliminar->siguiente;
+        if (estabaEnCola) {
+            cout << "  -> Proceso (PID: " << pid << ") eliminado de la Cola de CPU.\n";
         }
-    }
-
-    // 2. Si se encontr (aEliminar != NULL), eliminarlo de las otras estructuras
-    if (aEliminar != NULL) {
-        cout << "Proceso (PID: " << pid << ") encontrado. Eliminando de todas las estructuras...\n";
-        
-        // --- INICIO DE LA CORRECCIN ---
-        // 2.1 Eliminar de la Pila de Memoria
-        eliminarProcesosDePila(pid);
-        
-        // 2.2 Eliminar de la Cola de CPU
-        eliminarProcesoDeCola(pid);
-        // --- FIN DE LA CORRECCIN ---
-
-        delete aEliminar; // Libera la memoria
         cout << "Proceso con PID " << pid << " eliminado completamente.\n";
 
     } else {
@@ -277,21 +2033,64 @@ void eliminarProceso() {
     limpiarYPausar();
 }
 
+// Los mens muestran las vistas largas de a TAM_PAGINA elementos
+const int TAM_PAGINA = 20;
+
+// Pregunta si mostrar la pgina siguiente. Lee la respuesta con getline:
+// el llamador ya descart el Enter de la opcin del men.
+bool seguirPaginando() {
+    cout << "-- Enter: siguiente pagina, q + Enter: volver -- ";
+    string respuesta;
+    if (!getline(cin, respuesta)) return false;
+    return respuesta.empty() || (respuesta[0] != 'q' && respuesta[0] != 'Q');
+}
+
+// Como limpiarYPausar, cuando el Enter anterior ya se ley
+void pausar() {
+    confirmarBitacora();
+    cout << "Presione Enter para continuar...";
+    cin.get();
+    system("cls || clear");
+}
+
 // 1.3 Mostrar todos los procesos
 void mostrarProcesos() {
     cout << "\n--- Lista de Todos los Procesos ---\n";
-    if (cabezaProcesos == NULL) {
-        cout << "No hay procesos registrados.\n";
-    } else {
-        Proceso* actual = cabezaProcesos;
-        while (actual != NULL) {
-            cout << "PID: " << actual->pid 
-                 << ", Nombre: " << actual->nombre 
-                 << ", Prioridad: " << actual->prioridad << "\n";
-            actual = actual->siguiente;
-        }
+    if (cabezaProcesos == NULL) cout << "No hay procesos registrados.\n";
+    limpiarBuffer();
+    Proceso* p = cabezaProcesos;
+    while ((p = imprimirTramoProcesos(p, TAM_PAGINA)) != NULL && seguirPaginando()) {
     }
-    limpiarYPausar();
+    pausar();
+}
+
+// 1.4 Buscar procesos por rango de prioridad
+void mostrarRangoPrioridad() {
+    int minimo, maximo;
+    cout << "Ingrese la prioridad minima: ";
+    if (!(cin >> minimo)) {
+        cout << "Prioridad invalida.\n";
+        limpiarBuffer();
+        limpiarYPausar();
+        return;
+    }
+    cout << "Ingrese la prioridad maxima: ";
+    if (!(cin >> maximo)) {
+        cout << "Prioridad invalida.\n";
+        limpiarBuffer();
+        limpiarYPausar();
+        return;
+    }
+
+    long total = indicePrioridad.contar(minimo, maximo);
+    cout << "\n--- Procesos con Prioridad entre " << minimo << " y " << maximo << " (" << total << ") ---\n";
+    if (total == 0) cout << "No hay procesos en ese rango.\n";
+    limpiarBuffer();
+    CursorPrioridad c = indicePrioridad.desde(minimo);
+    int ultimo;
+    while (imprimirTramoRango(c, maximo, TAM_PAGINA, ultimo) && seguirPaginando()) {
+    }
+    pausar();
 }
 
 // --- PLANIFICADOR DE CPU (COLA DE PRIORIDAD) ---
@@ -307,77 +2106,71 @@ void encolarProcesoEnPlanificador() {
         return;
     }
 
-    Proceso* p = buscarProcesoPorPID(pid);
-    if (p == NULL) {
+    Resultado r = encolarProceso(pid);
+    if (r == ERROR_NO_EXISTE) {
         cout << "Error: Proceso con PID " << pid << " no existe en la lista general.\n";
-        limpiarYPausar();
-        return;
-    }
-
-    if (estaEnCola(pid)) {
+    } else if (r == ERROR_YA_EN_COLA) {
         cout << "Error: El proceso ya esta en la cola del planificador.\n";
-        limpiarYPausar();
-        return;
-    }
-
-    // Crear nuevo nodo para la cola
-    NodoCola* nuevo = new NodoCola();
-    nuevo->proceso = p;
-    nuevo->siguiente = NULL;
-
-    // Insertar en la cola por prioridad (menor nmero = mayor prioridad)
-    if (cabezaCola == NULL || p->prioridad < cabezaCola->proceso->prioridad) {
-        // Insertar al inicio
-        nuevo->siguiente = cabezaCola;
-        cabezaCola = nuevo;
+    } else if (r != OK) {
+        cout << "Error: " << mensajeError(r) << "\n";
     } else {
-        // Buscar posicin
-        NodoCola* actual = cabezaCola;
-        while (actual->siguiente != NULL && actual->siguiente->proceso->prioridad <= p->prioridad) {
-            actual = actual->siguiente;
-        }
-        nuevo->siguiente = actual->siguiente;
-        actual->siguiente = nuevo;
+        Proceso* p = buscarProcesoPorPID(pid);
+        cout << "Proceso " << nombreDe(p) << " (PID: " << p->pid << ") encolado.\n";
     }
-
-    cout << "Proceso " << p->nombre << " (PID: " << p->pid << ") encolado.\n";
     limpiarYPausar();
 }
 
 // 2.2 Desencolar y ejecutar proceso
 void desencolaryEjecutarProceso() {
-    if (cabezaCola == NULL) {
+    Proceso* p = ejecutarSiguiente();
+    if (p == NULL) {
         cout << "La cola del planificador esta vacia. No hay procesos que ejecutar.\n";
         limpiarYPausar();
         return;
     }
 
-    NodoCola* temp = cabezaCola; // Guardar el nodo a desencolar
-    Proceso* p = temp->proceso;
-    
-    cabezaCola = cabezaCola->siguiente; // Mover la cabeza al siguiente
-
     cout << "Ejecutando proceso (Mayor Prioridad):\n";
-    cout << "PID: " << p->pid << ", Nombre: " << p->nombre << ", Prioridad: " << p->prioridad << "\n";
-    
-    delete temp; // Liberar memoria del nodo de la cola
+    cout << "PID: " << p->pid << ", Nombre: " << nombreDe(p) << ", Prioridad: " << p->prioridad << "\n";
     limpiarYPausar();
 }
 
 // 2.3 Mostrar cola actual
 void mostrarColaPlanificador() {
     cout << "\n--- Cola de Planificacion (Orden de Ejecucion) ---\n";
-    if (cabezaCola == NULL) {
-        cout << "La cola esta vacia.\n";
+    if (cantidadEnCola() == 0) cout << "La cola esta vacia.\n";
+    limpiarBuffer();
+    RecorridoCola r;
+    int k = 0;
+    while (imprimirTramoCola(r, TAM_PAGINA, k) && seguirPaginando()) {
+    }
+    pausar();
+}
+
+// 2.4 Cambiar la prioridad de un proceso (est o no en la cola)
+void cambiarPrioridadProceso() {
+    int pid, prioridad;
+    cout << "Ingrese PID del proceso: ";
+    if (!(cin >> pid) || pid <= 0) {
+        cout << "PID invalido.\n";
+        limpiarBuffer();
+        limpiarYPausar();
+        return;
+    }
+    cout << "Ingrese la nueva prioridad (1 es mas prioritario): ";
+    if (!(cin >> prioridad)) {
+        cout << "Prioridad invalida.\n";
+        limpiarBuffer();
+        limpiarYPausar();
+        return;
+    }
+
+    Resultado r = cambiarPrioridad(pid, prioridad);
+    if (r != OK) {
+        cout << "Error: " << mensajeError(r) << "\n";
     } else {
-        NodoCola* actual = cabezaCola;
-        int i = 1;
-        while (actual != NULL) {
-            cout << i++ << ". PID: " << actual->proceso->pid 
-                 << ", Nombre: " << actual->proceso->nombre 
-                 << ", Prioridad: " << actual->proceso->prioridad << "\n";
-            actual = actual->siguiente;
-        }
+        Proceso* p = buscarProcesoPorPID(pid);
+        cout << "Proceso " << nombreDe(p) << " (PID: " << p->pid << ") ahora con prioridad " << p->prioridad
+             << (p->posCola >= 0 ? " (reubicado en la cola).\n" : ".\n");
     }
     limpiarYPausar();
 }
@@ -387,7 +2180,7 @@ void mostrarColaPlanificador() {
 // 3.1 Asignar memoria (Push)
 void asignarMemoria() {
     int pid, tamanio;
-    
+
     cout << "Ingrese PID del proceso al que se asignara memoria: ";
     if (!(cin >> pid) || pid <= 0) {
         cout << "PID invalido.\n";
@@ -412,54 +2205,731 @@ void asignarMemoria() {
     }
 
     // Crear nuevo bloque de memoria (Push)
-    BloqueMemoria* nuevo = new BloqueMemoria();
-    nuevo->proceso = p;
-    nuevo->tamanio = tamanio;
-    nuevo->siguiente = topeMemoria; // Enlaza al bloque anterior
-    topeMemoria = nuevo; // El nuevo bloque es ahora el tope
+    Resultado r = reservarMemoria(pid, tamanio);
+    if (r != OK) {
+        cout << "Error: " << mensajeError(r) << "\n";
+        limpiarYPausar();
+        return;
+    }
 
-    cout << "Memoria asignada al proceso " << p->nombre << " (PID: " << p->pid << ").\n";
+    cout << "Memoria asignada al proceso " << nombreDe(p) << " (PID: " << p->pid << ").\n";
+    if (topeMemoria->direccion >= 0) {
+        cout << "Direccion: " << topeMemoria->direccion << " KB\n";
+    }
     limpiarYPausar();
 }
 
 // 3.2 Liberar memoria (Pop)
 void liberarMemoria() {
-    if (topeMemoria == NULL) {
+    BloqueMemoria* temp = liberarTope();
+    if (temp == NULL) {
         cout << "La pila de memoria esta vacia. No hay nada que liberar.\n";
         limpiarYPausar();
         return;
     }
 
-    BloqueMemoria* temp = topeMemoria; // Guardar el bloque superior
-    topeMemoria = topeMemoria->siguiente; // Mover el tope al siguiente
-
-    cout << "Memoria liberada del proceso: " << temp->proceso->nombre 
+    cout << "Memoria liberada del proceso: " << nombreDe(temp->proceso)
          << " (PID: " << temp->proceso->pid << ", Tamano: " << temp->tamanio << "KB)\n";
-    
-    delete temp; // Liberar el bloque de memoria
+
+    poolBloques.devolver(temp); // Devolver el bloque al pool
     limpiarYPausar();
 }
 
 // 3.3 Ver estado actual de la memoria (Recorrer Pila)
 void estadoMemoria() {
     cout << "\n--- Estado Actual de la Pila de Memoria ---\n";
+    limpiarBuffer();
     if (topeMemoria == NULL) {
         cout << "Pila de memoria vacia. No hay memoria asignada.\n";
     } else {
         cout << "(Tope)\n";
-        BloqueMemoria* actual = topeMemoria;
-        while (actual != NULL) {
-            cout << "  Proceso: " << actual->proceso->nombre << " (PID: " << actual->proceso->pid << ")\n"
-                 << "  Tamano: " << actual->tamanio << " KB\n"
-                 << "  ||\n"
-                 << "  \\/\n";
-            actual = actual->siguiente;
+        BloqueMemoria* b = topeMemoria;
+        while ((b = imprimirTramoMemoria(b, TAM_PAGINA)) != NULL && seguirPaginando()) {
         }
-        cout << "(Base)\n";
+        if (b == NULL) cout << "(Base)\n";
     }
-    limpiarYPausar();
+    cout << "Total en uso: " << kbEnUso << " KB en " << poolBloques.vivos << " bloques\n";
+    if (memoriaBuddy.activo()) imprimirEstadoBuddy(memoriaBuddy);
+    pausar();
+}
+
+// 3.4 Ver los procesos con ms memoria (del ndice, de a TAM_PAGINA)
+void mostrarMayoresConsumidores() {
+    cout << "\n--- Mayores Consumidores de Memoria ---\n"
+         << "En uso: " << kbEnUso << " KB en " << poolBloques.vivos << " bloques\n";
+    if (indiceMemoria.cantidad == 0) cout << "Ningun proceso tiene memoria asignada.\n";
+    limpiarBuffer();
+    CursorPrioridad c = indiceMemoria.desde(numeric_limits<int>::min());
+    int k = 0;
+    while (imprimirTramoConsumidores(c, TAM_PAGINA, k) && seguirPaginando()) {
+    }
+    pausar();
+}
+
+
+// --- MODO SCRIPT (SIN MENS) ---
+// Lee comandos de un archivo (o de la entrada estndar con "-") y los ejecuta
+// con las operaciones base: sin limpiar pantalla, sin pausas y con la salida
+// en bfer. Un comando por lnea; las lneas vacas y las que empiezan con
+// '#' se ignoran.
+//
+//   insert <pid> <prioridad> <nombre...>
+//   delete <pid>
+//   enqueue <pid>
+//   renice <pid> <prioridad>   (tambin si est en la cola: se reubica en O(log n))
+//   dequeue
+//   push <pid> <KB>
+//   pop
+//   show processes|queue|memory|pools|summary
+//   save <archivo>    (guarda una instantnea; solo con el motor de listas)
+//   count <min> <max> (procesos con prioridad en el rango; solo con el motor de listas)
+//   usage [<pid>]     (KB en uso del proceso o de todos, en O(1); solo con el motor de listas)
+//   stats             (latencias y nodos visitados; requiere compilar con -DCON_METRICAS)
+//
+// Con el motor de listas, show acepta adems (ver Pagina):
+//   show processes [after <pid>] [limit <K>] [json]   K procesos desde el cursor
+//   show queue [limit <K>] [json]                     los K primeros en ejecutarse
+//   show memory [limit <K>] [json]                    los K ltimos bloques apilados
+//   show summary json
+//   show priority <min> <max> [after <pid>] [limit <K>] [json]
+//                     procesos con prioridad en el rango, por (prioridad, PID)
+//   show top [limit <K>] [json]                       los K procesos con ms memoria
+// 'json' imprime la vista en una sola lnea JSON, para otros programas.
+//
+// Las altas, bajas y push exitosos no imprimen nada; dequeue y pop informan
+// qu proceso sali, y los errores se reportan con su nmero de lnea.
+// Con --motor soa los mismos comandos usan la tabla en columnas (SoA).
+
+void saltarEspacios(const char*& c) {
+    while (*c == ' ' || *c == '\t' || *c == '\r') c++;
+}
+
+// Compara la siguiente palabra con 'w' y, si coincide, avanza el cursor
+bool leerPalabra(const char*& c, const char* w) {
+    saltarEspacios(c);
+    const char* a = c;
+    while (*w != '\0' && *a == *w) {
+        a++;
+        w++;
+    }
+    if (*w != '\0' || (*a != '\0' && *a != ' ' && *a != '\t' && *a != '\r')) return false;
+    c = a;
+    return true;
+}
+
+bool leerEntero(const char*& c, int& valor) {
+    saltarEspacios(c);
+    char* fin;
+    long v = strtol(c, &fin, 10);
+    if (fin == c || v < numeric_limits<int>::min() || v > numeric_limits<int>::max()) return false;
+    valor = (int)v;
+    c = fin;
+    return true;
+}
+
+// Copia el resto de la lnea sin los espacios de los extremos
+void leerResto(const char*& c, string& destino) {
+    saltarEspacios(c);
+    const char* fin = c + strlen(c);
+    while (fin > c && (fin[-1] == ' ' || fin[-1] == '\t' || fin[-1] == '\r')) fin--;
+    destino.assign(c, fin - c);
+    c = fin;
 }
 
+// Comando ya interpretado: el mismo formato sirve para los dos motores
+enum TipoComando {
+    CMD_INSERT,
+    CMD_DELETE,
+    CMD_ENQUEUE,
+    CMD_RENICE,
+    CMD_DEQUEUE,
+    CMD_PUSH,
+    CMD_POP,
+    CMD_SHOW,
+    CMD_SAVE,
+    CMD_COUNT,
+    CMD_USAGE,
+    CMD_STATS
+};
+
+enum Vista {
+    VISTA_PROCESOS,
+    VISTA_COLA,
+    VISTA_MEMORIA,
+    VISTA_POOLS,
+    VISTA_RESUMEN,
+    VISTA_PRIORIDAD,
+    VISTA_CONSUMIDORES
+};
+
+struct Comando {
+    TipoComando tipo;
+    int pid; // 0 en usage sin PID
+    int valor; // Prioridad (insert, renice), KB (push) o Vista (show)
+    string nombre; // Nombre del proceso (insert) o ruta del archivo (save)
+    Pagina pagina; // Opciones de show
+    int minimo, maximo; // Rango de prioridades (show priority, count)
+};
+
+// Interpreta una lnea del script. Retorna NULL si es vlida o el mensaje
+// de error (uso correcto) si no lo es.
+const char* parsearComando(const char* c, Comando& cmd) {
+    if (leerPalabra(c, "insert")) {
+        cmd.tipo = CMD_INSERT;
+        if (!leerEntero(c, cmd.pid) || !leerEntero(c, cmd.valor)) return "uso: insert <pid> <prioridad> <nombre>";
+        leerResto(c, cmd.nombre);
+    } else if (leerPalabra(c, "save")) {
+        cmd.tipo = CMD_SAVE;
+        leerResto(c, cmd.nombre);
+        if (cmd.nombre.empty()) return "uso: save <archivo>";
+    } else if (leerPalabra(c, "delete")) {
+        cmd.tipo = CMD_DELETE;
+        if (!leerEntero(c, cmd.pid)) return "uso: delete <pid>";
+    } else if (leerPalabra(c, "enqueue")) {
+        cmd.tipo = CMD_ENQUEUE;
+        if (!leerEntero(c, cmd.pid)) return "uso: enqueue <pid>";
+    } else if (leerPalabra(c, "renice")) {
+        cmd.tipo = CMD_RENICE;
+        if (!leerEntero(c, cmd.pid) || !leerEntero(c, cmd.valor)) return "uso: renice <pid> <prioridad>";
+    } else if (leerPalabra(c, "dequeue")) {
+        cmd.tipo = CMD_DEQUEUE;
+    } else if (leerPalabra(c, "push")) {
+        cmd.tipo = CMD_PUSH;
+        if (!leerEntero(c, cmd.pid) || !leerEntero(c, cmd.valor)) return "uso: push <pid> <KB>";
+    } else if (leerPalabra(c, "pop")) {
+        cmd.tipo = CMD_POP;
+    } else if (leerPalabra(c, "count")) {
+        cmd.tipo = CMD_COUNT;
+        if (!leerEntero(c, cmd.minimo) || !leerEntero(c, cmd.maximo)) return "uso: count <min> <max>";
+    } else if (leerPalabra(c, "stats")) {
+        cmd.tipo = CMD_STATS;
+    } else if (leerPalabra(c, "usage")) {
+        cmd.tipo = CMD_USAGE;
+        cmd.pid = 0;
+        saltarEspacios(c);
+        if (*c != '\0' && (!leerEntero(c, cmd.pid) || cmd.pid <= 0)) return "uso: usage [<pid>]";
+    } else if (leerPalabra(c, "show")) {
+        cmd.tipo = CMD_SHOW;
+        if (leerPalabra(c, "processes")) cmd.valor = VISTA_PROCESOS;
+        else if (leerPalabra(c, "queue")) cmd.valor = VISTA_COLA;
+        else if (leerPalabra(c, "memory")) cmd.valor = VISTA_MEMORIA;
+        else if (leerPalabra(c, "pools")) cmd.valor = VISTA_POOLS;
+        else if (leerPalabra(c, "summary")) cmd.valor = VISTA_RESUMEN;
+        else if (leerPalabra(c, "priority")) cmd.valor = VISTA_PRIORIDAD;
+        else if (leerPalabra(c, "top")) cmd.valor = VISTA_CONSUMIDORES;
+        else return "uso: show processes|queue|memory|pools|summary|priority|top";
+        if (cmd.valor == VISTA_PRIORIDAD && (!leerEntero(c, cmd.minimo) || !leerEntero(c, cmd.maximo))) {
+            return "uso: show priority <min> <max> [after <pid>] [limit <K>] [json]";
+        }
+        cmd.pagina = Pagina();
+        bool conCursor = cmd.valor == VISTA_PROCESOS || cmd.valor == VISTA_PRIORIDAD;
+        bool conLimite = conCursor || cmd.valor == VISTA_COLA || cmd.valor == VISTA_MEMORIA
+                         || cmd.valor == VISTA_CONSUMIDORES;
+        while (true) {
+            saltarEspacios(c);
+            if (*c == '\0') break;
+            if (leerPalabra(c, "json") && cmd.valor != VISTA_POOLS) {
+                cmd.pagina.json = true;
+            } else if (leerPalabra(c, "limit") && conLimite) {
+                if (!leerEntero(c, cmd.pagina.limite) || cmd.pagina.limite <= 0) return "uso: limit <K> (K > 0)";
+            } else if (leerPalabra(c, "after") && conCursor) {
+                if (!leerEntero(c, cmd.pagina.despues) || cmd.pagina.despues <= 0) return "uso: after <pid>";
+            } else {
+                return "uso: show processes [after <pid>] [limit <K>] [json] | queue|memory [limit <K>] [json]"
+                       " | summary [json] | pools | priority <min> <max> [after <pid>] [limit <K>] [json]"
+                       " | top [limit <K>] [json]";
+            }
+        }
+    } else {
+        return "comando desconocido";
+    }
+    return NULL;
+}
+
+void imprimirResumen(const ResumenProcesos& r) {
+    cout << "\n--- Resumen de Procesos ---\n";
+    cout << "Total: " << r.total << ", En cola: " << r.enCola;
+    if (r.ejecutados >= 0) cout << ", Ejecutados: " << r.ejecutados;
+    cout << "\n";
+    if (r.total > 0) {
+        cout << "Prioridad min: " << r.minPrioridad
+             << ", max: " << r.maxPrioridad
+             << ", promedio: " << (double)r.sumaPrioridad / r.total << "\n";
+    }
+}
+
+void imprimirResumenJSON(const ResumenProcesos& r) {
+    cout << "{\"vista\":\"resumen\",\"total\":" << r.total << ",\"enCola\":" << r.enCola;
+    if (r.ejecutados >= 0) cout << ",\"ejecutados\":" << r.ejecutados;
+    if (r.total > 0) {
+        cout << ",\"minPrioridad\":" << r.minPrioridad << ",\"maxPrioridad\":" << r.maxPrioridad
+             << ",\"promedioPrioridad\":" << (double)r.sumaPrioridad / r.total;
+    }
+    cout << "}\n";
+}
+
+#ifdef CON_METRICAS
+void imprimirFilaMetricas(const char* nombre, const Histograma& h) {
+    cout << nombre << ": " << h.cantidad;
+    if (h.cantidad > 0) {
+        cout << ", prom " << h.promedio()
+             << ", p50 " << h.percentil(0.50)
+             << ", p99 " << h.percentil(0.99)
+             << ", p99.9 " << h.percentil(0.999)
+             << ", max " << h.maximo;
+    }
+    cout << "\n";
+}
+#endif
+
+// Vuelca los histogramas (comando stats)
+void imprimirMetricas() {
+#ifdef CON_METRICAS
+    static const char* const operaciones[OPERACIONES_MEDIDAS] = {
+        "crear", "borrar", "encolar", "ejecutar", "reservar", "liberar", "renice", "buscar por PID", "show",
+        "save"
+    };
+    static const char* const recorridos[RECORRIDOS_MEDIDOS] = {
+        "buscar por PID (casillas)", "monticulo: subir (niveles)", "monticulo: bajar (niveles)",
+        "borrar: bloques de memoria"
+    };
+    cout << "\n--- Metricas: latencia por operacion (ns) ---\n";
+    for (int i = 0; i < OPERACIONES_MEDIDAS; i++) imprimirFilaMetricas(operaciones[i], latencias[i]);
+    cout << "--- Metricas: nodos visitados por llamada ---\n";
+    for (int i = 0; i < RECORRIDOS_MEDIDOS; i++) imprimirFilaMetricas(recorridos[i], visitas[i]);
+#else
+    cout << "Metricas desactivadas: compilar con -DCON_METRICAS.\n";
+#endif
+}
+
+// Sale del ndice de prioridades y de la cola, sin recorrer la lista.
+// Este motor no guarda si un proceso ya se ejecut.
+ResumenProcesos resumenListas() {
+    ResumenProcesos r;
+    r.total = indicePrioridad.cantidad;
+    r.enCola = cantidadEnCola();
+    r.ejecutados = -1;
+    r.sumaPrioridad = indicePrioridad.sumaPrioridades;
+    r.minPrioridad = r.maxPrioridad = 0;
+    if (r.total > 0) {
+        r.minPrioridad = indicePrioridad.minimaPrioridad();
+        r.maxPrioridad = indicePrioridad.maximaPrioridad();
+    }
+    return r;
+}
+
+// Ejecuta un comando con el motor de listas. Retorna false si hubo un error.
+bool ejecutarComando(const Comando& cmd, long numLinea) {
+    Resultado r = OK;
+
+    switch (cmd.tipo) {
+        case CMD_INSERT:
+            r = crearProceso(cmd.pid, cmd.nombre, cmd.valor);
+            break;
+        case CMD_DELETE:
+            r = borrarProceso(cmd.pid, NULL, NULL);
+            break;
+        case CMD_ENQUEUE:
+            r = encolarProceso(cmd.pid);
+            break;
+        case CMD_RENICE:
+            r = cambiarPrioridad(cmd.pid, cmd.valor);
+            break;
+        case CMD_DEQUEUE: {
+            Proceso* p = ejecutarSiguiente();
+            if (p == NULL) {
+                cout << "linea " << numLinea << ": La cola del planificador esta vacia.\n";
+                return false;
+            }
+            cout << "Ejecutando PID: " << p->pid << ", Nombre: " << nombreDe(p) << ", Prioridad: " << p->prioridad << "\n";
+            break;
+        }
+        case CMD_PUSH:
+            r = reservarMemoria(cmd.pid, cmd.valor);
+            break;
+        case CMD_POP: {
+            BloqueMemoria* b = liberarTope();
+            if (b == NULL) {
+                cout << "linea " << numLinea << ": La pila de memoria esta vacia.\n";
+                return false;
+            }
+            cout << "Liberado PID: " << b->proceso->pid << ", Tamano: " << b->tamanio << "KB\n";
+            poolBloques.devolver(b);
+            break;
+        }
+        case CMD_SHOW: {
+            MEDIR_OPERACION(OP_VISTA);
+            switch (cmd.valor) {
+                case VISTA_PROCESOS:
+                    // El cursor tiene que seguir existiendo
+                    if (cmd.pagina.despues != 0 && buscarProcesoPorPID(cmd.pagina.despues) == NULL) r = ERROR_NO_EXISTE;
+                    else imprimirProcesos(cmd.pagina);
+                    break;
+                case VISTA_COLA: imprimirCola(cmd.pagina); break;
+                case VISTA_MEMORIA: imprimirMemoria(cmd.pagina); break;
+                case VISTA_POOLS: imprimirPools(); break;
+                case VISTA_RESUMEN:
+                    if (cmd.pagina.json) imprimirResumenJSON(resumenListas());
+                    else imprimirResumen(resumenListas());
+                    break;
+                case VISTA_PRIORIDAD:
+                    if (cmd.pagina.despues != 0 && buscarProcesoPorPID(cmd.pagina.despues) == NULL) r = ERROR_NO_EXISTE;
+                    else imprimirRangoPrioridad(cmd.minimo, cmd.maximo, cmd.pagina);
+                    break;
+                case VISTA_CONSUMIDORES: imprimirMayoresConsumidores(cmd.pagina); break;
+            }
+            break;
+        }
+        case CMD_COUNT:
+            cout << "Procesos con prioridad entre " << cmd.minimo << " y " << cmd.maximo << ": "
+                 << indicePrioridad.contar(cmd.minimo, cmd.maximo) << "\n";
+            break;
+        case CMD_STATS:
+            imprimirMetricas();
+            break;
+        case CMD_USAGE:
+            if (cmd.pid == 0) {
+                cout << "Memoria en uso: " << kbEnUso << " KB en " << poolBloques.vivos << " bloques, "
+                     << indiceMemoria.cantidad << " procesos con memoria\n";
+            } else {
+                Proceso* p = buscarProcesoPorPID(cmd.pid);
+                if (p == NULL) r = ERROR_NO_EXISTE;
+                else cout << "PID " << p->pid << ": " << p->kbMemoria << " KB en " << p->bloquesMemoria << " bloques\n";
+            }
+            break;
+        case CMD_SAVE: {
+            const char* error = guardarInstantanea(cmd.nombre.c_str());
+            if (error != NULL) {
+                cout << "linea " << numLinea << ": No se pudo guardar " << cmd.nombre << ": " << error << "\n";
+                return false;
+            }
+            break;
+        }
+    }
+
+    if (r != OK) {
+        cout << "linea " << numLinea << ": Error: " << mensajeError(r) << "\n";
+        return false;
+    }
+    return true;
+}
+
+
+// --- MOTOR ALTERNATIVO: TABLA DE PROCESOS EN COLUMNAS (SoA) ---
+// Mismos comandos que el motor de listas, pero los procesos viven en
+// TablaProcesosSoA y la cola y la pila los referencian con manejadores
+// (ranura + generacin), que se verifican antes de leer el proceso.
+// Se elige con --motor soa en el modo script.
+
+MotorSoA motorSoA;
+
+const char* nombreEstado(unsigned char estado) {
+    switch (estado) {
+        case ESTADO_EN_COLA: return "En cola";
+        case ESTADO_EJECUTADO: return "Ejecutado";
+    }
+    return "Listo";
+}
+
+void imprimirProcesoSoA(unsigned ranura) {
+    const TablaProcesosSoA& t = motorSoA.tabla;
+    cout << "PID: " << t.pidDe(ranura) << ", Nombre: ";
+    cout.write(t.nombreDe(ranura), t.largoNombreDe(ranura));
+    cout << ", Prioridad: " << t.prioridadDe(ranura);
+}
+
+// Las columnas se recorren en orden denso (no en orden de insercin)
+void imprimirProcesosSoA() {
+    const TablaProcesosSoA& t = motorSoA.tabla;
+    cout << "\n--- Lista de Todos los Procesos (SoA) ---\n";
+    if (t.cantidad == 0) {
+        cout << "No hay procesos registrados.\n";
+        return;
+    }
+    for (unsigned d = 0; d < t.cantidad; d++) {
+        imprimirProcesoSoA(t.ranuraDe[d]);
+        cout << ", Estado: " << nombreEstado(t.estados[d]) << "\n";
+    }
+}
+
+void imprimirColaSoA() {
+    const ColaSoA& cola = motorSoA.cola;
+    const TablaProcesosSoA& t = motorSoA.tabla;
+    cout << "\n--- Cola de Planificacion (Orden de Ejecucion) ---\n";
+    if (cola.cantidad == 0) {
+        cout << "La cola esta vacia.\n";
+        return;
+    }
+    int n = cola.cantidad;
+    NodoColaSoA* copia = new NodoColaSoA[n];
+    for (int i = 0; i < n; i++) copia[i] = cola.nodos[i];
+    sort(copia, copia + n, ColaSoA::antes);
+    for (int i = 0; i < n; i++) {
+        cout << i + 1 << ". ";
+        if (t.valido(copia[i].proceso)) imprimirProcesoSoA(copia[i].proceso.ranura);
+        else cout << "[proceso borrado]";
+        cout << "\n";
+    }
+    delete[] copia;
+}
+
+void imprimirMemoriaSoA() {
+    const PilaBloquesSoA& pila = motorSoA.pila;
+    const TablaProcesosSoA& t = motorSoA.tabla;
+    cout << "\n--- Estado Actual de la Pila de Memoria ---\n";
+    if (pila.tope == -1) {
+        cout << "Pila de memoria vacia. No hay memoria asignada.\n";
+        return;
+    }
+    cout << "(Tope)\n";
+    for (int b = pila.tope; b != -1; b = pila.bloques[b].siguiente) {
+        ManejadorProceso h = pila.bloques[b].proceso;
+        cout << "  Proceso: ";
+        if (t.valido(h)) {
+            cout.write(t.nombreDe(h.ranura), t.largoNombreDe(h.ranura));
+            cout << " (PID: " << t.pidDe(h.ranura) << ")\n";
+        } else {
+            cout << "[proceso borrado]\n";
+        }
+        cout << "  Tamano: " << pila.bloques[b].tamanio << " KB\n"
+             << "  ||\n"
+             << "  \\/\n";
+    }
+    cout << "(Base)\n";
+}
+
+// Ejecuta un comando con el motor SoA. Retorna false si hubo un error.
+bool ejecutarComandoSoA(const Comando& cmd, long numLinea) {
+    TablaProcesosSoA& t = motorSoA.tabla;
+    Resultado r = OK;
+
+    switch (cmd.tipo) {
+        case CMD_INSERT:
+            if (cmd.pid <= 0) r = ERROR_PID_INVALIDO;
+            else if (t.ranuraDePID(cmd.pid) != 0) r = ERROR_PID_DUPLICADO;
+            else if (cmd.nombre.empty()) r = ERROR_NOMBRE_VACIO;
+            else if (cmd.valor <= 0) r = ERROR_PRIORIDAD_INVALIDA;
+            else t.crear(cmd.pid, cmd.nombre.data(), (unsigned)cmd.nombre.size(), cmd.valor);
+            break;
+        case CMD_DELETE: {
+            unsigned ranura = t.ranuraDePID(cmd.pid);
+            if (ranura == 0) r = ERROR_NO_EXISTE;
+            else motorSoA.borrar(ranura);
+            break;
+        }
+        case CMD_ENQUEUE: {
+            unsigned ranura = t.ranuraDePID(cmd.pid);
+            if (ranura == 0) r = ERROR_NO_EXISTE;
+            else if (t.posCola[ranura] >= 0) r = ERROR_YA_EN_COLA;
+            else {
+                motorSoA.cola.insertar(t.manejador(ranura));
+                t.fijarEstado(ranura, ESTADO_EN_COLA);
+            }
+            break;
+        }
+        case CMD_RENICE: {
+            unsigned ranura = t.ranuraDePID(cmd.pid);
+            if (ranura == 0) r = ERROR_NO_EXISTE;
+            else if (cmd.valor <= 0) r = ERROR_PRIORIDAD_INVALIDA;
+            else motorSoA.cambiarPrioridad(ranura, cmd.valor);
+            break;
+        }
+        case CMD_DEQUEUE: {
+            ManejadorProceso h = motorSoA.cola.extraer();
+            if (h.ranura == 0) {
+                cout << "linea " << numLinea << ": La cola del planificador esta vacia.\n";
+                return false;
+            }
+            if (!t.valido(h)) { // La ranura se liber (y quizs se reus) mientras esperaba
+                r = ERROR_NO_EXISTE;
+                break;
+            }
+            t.fijarEstado(h.ranura, ESTADO_EJECUTADO);
+            cout << "Ejecutando ";
+            imprimirProcesoSoA(h.ranura);
+            cout << "\n";
+            break;
+        }
+        case CMD_PUSH: {
+            unsigned ranura = t.ranuraDePID(cmd.pid);
+            if (ranura == 0) r = ERROR_NO_EXISTE;
+            else if (cmd.valor <= 0) r = ERROR_TAMANIO_INVALIDO;
+            else motorSoA.pila.apilar(t.manejador(ranura), cmd.valor);
+            break;
+        }
+        case CMD_POP: {
+            PilaBloquesSoA& pila = motorSoA.pila;
+            if (pila.tope == -1) {
+                cout << "linea " << numLinea << ": La pila de memoria esta vacia.\n";
+                return false;
+            }
+            int b = pila.tope;
+            ManejadorProceso h = pila.bloques[b].proceso;
+            if (t.valido(h)) cout << "Liberado PID: " << t.pidDe(h.ranura);
+            else cout << "Liberado bloque de un proceso borrado";
+            cout << ", Tamano: " << pila.bloques[b].tamanio << "KB\n";
+            pila.desapilar(b);
+            break;
+        }
+        case CMD_SHOW:
+            if (cmd.pagina.limite != 0 || cmd.pagina.despues != 0 || cmd.pagina.json) {
+                cout << "linea " << numLinea << ": after, limit y json solo estan disponibles con el motor de listas.\n";
+                return false;
+            }
+            switch (cmd.valor) {
+                case VISTA_PROCESOS: imprimirProcesosSoA(); break;
+                case VISTA_COLA: imprimirColaSoA(); break;
+                case VISTA_MEMORIA: imprimirMemoriaSoA(); break;
+                case VISTA_POOLS:
+                    cout << "\n--- Motor SoA ---\n"
+                         << "Procesos: " << t.cantidad << " (capacidad " << t.capacidad << ")\n";
+                    imprimirBytesPorProceso(t.bytesReservados(), t.cantidad, motorSoA.nombres);
+                    break;
+                case VISTA_RESUMEN: imprimirResumen(t.resumen()); break;
+                case VISTA_PRIORIDAD:
+                case VISTA_CONSUMIDORES:
+                    cout << "linea " << numLinea << ": show priority y show top solo estan disponibles con el motor de listas.\n";
+                    return false;
+            }
+            break;
+        case CMD_SAVE:
+            cout << "linea " << numLinea << ": save solo esta disponible con el motor de listas.\n";
+            return false;
+        case CMD_COUNT:
+        case CMD_USAGE:
+            cout << "linea " << numLinea << ": count y usage solo estan disponibles con el motor de listas.\n";
+            return false;
+        case CMD_STATS:
+            imprimirMetricas(); // Este motor no se mide: solo muestra lo que haya
+            break;
+    }
+
+    if (r != OK) {
+        cout << "linea " << numLinea << ": Error: " << mensajeError(r) << "\n";
+        return false;
+    }
+    return true;
+}
+
+enum Motor {
+    MOTOR_LISTAS,
+    MOTOR_SOA
+};
+
+// Ejecuta todas las lneas de 'entrada'. Retorna la cantidad de errores.
+long ejecutarScript(istream& entrada, Motor motor) {
+    string linea;
+    Comando cmd; // Se reutiliza entre lneas para no pedir memoria cada vez
+    long numLinea = 0, comandos = 0, errores = 0;
+    while (true) {
+        // Si la prxima lnea todava no lleg, lo anotado se confirma antes de esperarla
+        if (entrada.rdbuf()->in_avail() <= 0) confirmarBitacora();
+        if (!getline(entrada, linea)) break;
+        numLinea++;
+        const char* c = linea.c_str();
+        saltarEspacios(c);
+        if (*c == '\0' || *c == '#') continue;
+        comandos++;
+
+        const char* error = parsearComando(c, cmd);
+        bool ok;
+        if (error != NULL) {
+            cout << "linea " << numLinea << ": " << error << "\n";
+            ok = false;
+        } else if (motor == MOTOR_SOA) {
+            ok = ejecutarComandoSoA(cmd, numLinea);
+        } else {
+            ok = ejecutarComando(cmd, numLinea);
+        }
+        if (!ok) errores++;
+    }
+    cout.flush();
+    cerr << comandos << " comandos ejecutados, " << errores << " con error.\n";
+    return errores;
+}
+
+#ifdef CON_HILOS
+// --- CARGA CONCURRENTE (--concurrente) ---
+// Varios hilos dan de alta, buscan y borran procesos en el registro del
+// gestor con crearProceso, buscarProcesoPorPID y borrarProceso. Las
+// bsquedas solo toman el cerrojo de lectura de un fragmento; las altas y
+// bajas, el de escritura de su fragmento y, un momento, cerrojoGestor para
+// la lista, los ndices ordenados y los nombres. El resto de las
+// operaciones (cola, memoria, vistas) sigue siendo del hilo principal.
+//
+// Necesita C++11 e hilos, as que solo se compila con CON_HILOS:
+//     g++ -O2 -std=c++11 -pthread -DCON_HILOS main.cpp
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+// Carga de prueba: 'escritores' hilos registran 'procesos' PIDs (cada uno
+// su tramo) mientras 'lectores' hilos buscan PIDs al azar; despus los
+// escritores borran todo. Informa operaciones por segundo de cada fase.
+void escribirTramo(int desde, int hasta, bool borrar, long* errores) {
+    string nombre = "concurrente";
+    for (int pid = desde; pid < hasta; pid++) {
+        Resultado r = borrar ? borrarProceso(pid, NULL, NULL) : crearProceso(pid, nombre, 1 + pid % 100);
+        if (r != OK) (*errores)++;
+    }
+}
+
+void leerAlAzar(int procesos, int semilla, const atomic<bool>* fin, long* busquedas, long* encontrados) {
+    unsigned x = 2463534242u + semilla;
+    long b = 0, e = 0;
+    while (!fin->load(memory_order_relaxed)) {
+        for (int k = 0; k < 256; k++) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            // Solo se mira si est: un escritor puede borrar el proceso enseguida
+            if (buscarProcesoPorPID(1 + (int)(x % (unsigned)procesos)) != NULL) e++;
+        }
+        b += 256;
+    }
+    *busquedas = b;
+    *encontrados = e;
+}
+
+double correrFase(int procesos, int escritores, int lectores, bool borrar, long& errores, long& busquedas) {
+    vector<long> erroresPorHilo(escritores, 0), busq(lectores, 0), enc(lectores, 0);
+    atomic<bool> fin(false);
+    vector<thread> lectoresHilos, escritoresHilos;
+    for (int i = 0; i < lectores; i++) {
+        lectoresHilos.push_back(thread(leerAlAzar, procesos, i, &fin, &busq[i], &enc[i]));
+    }
+    chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+    for (int i = 0; i < escritores; i++) {
+        int desde = 1 + (int)((long long)procesos * i / escritores);
+        int hasta = 1 + (int)((long long)procesos * (i + 1) / escritores);
+        escritoresHilos.push_back(thread(escribirTramo, desde, hasta, borrar, &erroresPorHilo[i]));
+    }
+    for (int i = 0; i < escritores; i++) escritoresHilos[i].join();
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    fin.store(true);
+    for (int i = 0; i < lectores; i++) lectoresHilos[i].join();
+
+    errores = busquedas = 0;
+    for (int i = 0; i < escritores; i++) errores += erroresPorHilo[i];
+    for (int i = 0; i < lectores; i++) busquedas += busq[i];
+    return segundos;
+}
+
+void correrCargaConcurrente(int procesos, int escritores, int lectores) {
+    long errores, busquedas;
+    cout << "Registro concurrente: " << FRAGMENTOS_PROCESOS << " fragmentos, " << escritores
+         << " escritores, " << lectores << " lectores, " << thread::hardware_concurrency()
+         << " nucleos en la maquina\n";
+    for (int fase = 0; fase < 2; fase++) {
+        double seg = correrFase(procesos, escritores, lectores, fase == 1, errores, busquedas);
+        cout << (fase == 0 ? "Insertar: " : "Eliminar: ") << procesos / seg << " ops/s de escritura, "
+             << busquedas / seg << " busquedas/s, " << errores << " errores\n";
+        if (fase == 0) cout << "Procesos en la tabla: " << registroProcesos.cantidad() << "\n";
+    }
+}
+#endif
 
 // --- MEN PRINCIPAL ---
 
@@ -471,9 +2941,11 @@ void menuGestorProcesos() {
         cout << "1. Insertar nuevo proceso\n";
         cout << "2. Eliminar proceso\n";
         cout << "3. Mostrar todos los procesos\n";
-        cout << "4. Volver al menu principal\n";
-        cout << "Seleccione una opcion (1-4): ";
+        cout << "4. Buscar procesos por rango de prioridad\n";
+        cout << "5. Volver al menu principal\n";
+        cout << "Seleccione una opcion (1-5): ";
         
+        confirmarBitacora();
         if (!(cin >> opcion)) {
             cout << "Opcion invalida.\n";
             limpiarBuffer();
@@ -484,10 +2956,11 @@ void menuGestorProcesos() {
             case 1: insertarProceso(); break;
             case 2: eliminarProceso(); break;
             case 3: mostrarProcesos(); break;
-            case 4: cout << "Volviendo al menu principal...\n"; break;
+            case 4: mostrarRangoPrioridad(); break;
+            case 5: cout << "Volviendo al menu principal...\n"; break;
             default: cout << "Opcion invalida.\n"; limpiarYPausar(); break;
         }
-    } while (opcion != 4);
+    } while (opcion != 5);
 }
 
 void menuPlanificadorCPU() {
@@ -498,9 +2971,11 @@ void menuPlanificadorCPU() {
         cout << "1. Encolar proceso por PID\n";
         cout << "2. Desencolar y ejecutar proceso (Mayor Prioridad)\n";
         cout << "3. Mostrar cola actual\n";
-        cout << "4. Volver al menu principal\n";
-        cout << "Seleccione una opcion (1-4): ";
+        cout << "4. Cambiar prioridad de un proceso\n";
+        cout << "5. Volver al menu principal\n";
+        cout << "Seleccione una opcion (1-5): ";
         
+        confirmarBitacora();
         if (!(cin >> opcion)) {
             cout << "Opcion invalida.\n";
             limpiarBuffer();
@@ -511,10 +2986,11 @@ void menuPlanificadorCPU() {
             case 1: encolarProcesoEnPlanificador(); break;
             case 2: desencolaryEjecutarProceso(); break;
             case 3: mostrarColaPlanificador(); break;
-            case 4: cout << "Volviendo al menu principal...\n"; break;
+            case 4: cambiarPrioridadProceso(); break;
+            case 5: cout << "Volviendo al menu principal...\n"; break;
             default: cout << "Opcion invalida.\n"; limpiarYPausar(); break;
         }
-    } while (opcion != 4);
+    } while (opcion != 5);
 }
 
 void menuGestorMemoria() {
@@ -525,9 +3001,11 @@ void menuGestorMemoria() {
         cout << "1. Asignar memoria a proceso (Push)\n";
         cout << "2. Liberar memoria (Pop)\n";
         cout << "3. Ver estado actual de la memoria\n";
-        cout << "4. Volver al menu principal\n";
-        cout << "Seleccione una opcion (1-4): ";
+        cout << "4. Ver procesos con mas memoria\n";
+        cout << "5. Volver al menu principal\n";
+        cout << "Seleccione una opcion (1-5): ";
         
+        confirmarBitacora();
         if (!(cin >> opcion)) {
             cout << "Opcion invalida.\n";
             limpiarBuffer();
@@ -538,13 +3016,208 @@ void menuGestorMemoria() {
             case 1: asignarMemoria(); break;
             case 2: liberarMemoria(); break;
             case 3: estadoMemoria(); break;
-            case 4: cout << "Volviendo al menu principal...\n"; break;
+            case 4: mostrarMayoresConsumidores(); break;
+            case 5: cout << "Volviendo al menu principal...\n"; break;
             default: cout << "Opcion invalida.\n"; limpiarYPausar(); break;
         }
-    } while (opcion != 4);
+    } while (opcion != 5);
+}
+
+// Libera todas las estructuras al salir
+void liberarTodo() {
+    // --- Limpieza final de memoria (Buena prctica) ---
+    // (Opcional para este ejercicio, pero importante en proyectos reales)
+    // Los procesos y los bloques viven en slabs: se sueltan de a slabs
+    // completos, sin recorrer la lista ni la pila nodo por nodo.
+    registroProcesos.liberarTodo();
+    poolBloques.liberarTodo();
+    indicePrioridad.vaciar();
+    indiceMemoria.vaciar();
+    kbEnUso = 0;
+    cabezaProcesos = finProcesos = NULL;
+    topeMemoria = NULL;
+    // La cola de CPU (colaCPU) libera su arreglo en su destructor
+}
+
+// Guarda la instantnea pedida con --guardar (si se pidi). Retorna false si fall.
+bool guardarAlSalir(const char* ruta) {
+    if (ruta == NULL) return true;
+    const char* error = guardarInstantanea(ruta);
+    if (error != NULL) cerr << "No se pudo guardar " << ruta << ": " << error << "\n";
+    return error == NULL;
 }
 
-int main() {
+// Los benchmarks (benchmark/) incluyen este archivo con SIN_MAIN definido
+// para usar las estructuras sin el men.
+#ifndef SIN_MAIN
+// Uso: sin argumentos abre los mens interactivos.
+//      --script <archivo> [--motor listas|soa]
+//          ejecuta los comandos del archivo ("-" = entrada estndar)
+//      --buddy <KB>
+//          activa el pool de memoria con direcciones (asignador buddy) de
+//          ese tamao, en los mens o en el modo script con el motor de listas
+//      --planificador monticulo|niveles
+//          cola de CPU a usar con el motor de listas (por defecto, montculo)
+//      --envejecimiento <E>
+//          con el montculo, un proceso en espera gana un nivel de prioridad
+//          cada E llegadas a la cola (ver ColaPrioridad). Una bitcora solo
+//          se reproduce con el mismo E con que se escribi.
+//      --cargar <archivo>
+//          arranca con el estado de una instantnea (motor de listas)
+//      --guardar <archivo>
+//          guarda una instantnea al salir (motor de listas)
+//      --importar <archivo>
+//          crea en bloque los procesos de un archivo CSV o JSONL, despus
+//          de --cargar (motor de listas; no se combina con --wal)
+//      --wal <archivo> [--wal-ms <N>]
+//          anota cada operacin en una bitcora y, al arrancar, reproduce lo
+//          que la instantnea cargada no incluye (motor de listas). Las
+//          operaciones van al disco juntas cada N ms (por defecto 10 en el
+//          modo script y 0, una por una, en los mens).
+int main(int argc, char* argv[]) {
+    const char* script = NULL;
+    const char* cargar = NULL;
+    const char* guardar = NULL;
+    const char* importar = NULL;
+    const char* wal = NULL;
+    int walMs = -1;
+    int envejecimiento = 0;
+    Motor motor = MOTOR_LISTAS;
+    bool argumentosOk = true;
+#ifdef CON_HILOS
+    // --concurrente <procesos> <escritores> <lectores>: carga con varios
+    // hilos sobre el registro de procesos del gestor
+    if (argc == 5 && string(argv[1]) == "--concurrente") {
+        int procesos = atoi(argv[2]), escritores = atoi(argv[3]), lectores = atoi(argv[4]);
+        if (procesos <= 0 || escritores <= 0 || lectores < 0) {
+            cerr << "Uso: " << argv[0] << " --concurrente <procesos> <escritores> <lectores>\n";
+            return 2;
+        }
+#ifdef CON_METRICAS
+        // Los histogramas de las mtricas son de un solo hilo
+        cerr << "--concurrente no se puede usar con CON_METRICAS\n";
+        return 2;
+#endif
+        correrCargaConcurrente(procesos, escritores, lectores);
+        return 0;
+    }
+#endif
+    for (int i = 1; i < argc && argumentosOk; i++) {
+        string arg = argv[i];
+        bool hayValor = i + 1 < argc;
+        if (arg == "--script" && hayValor) {
+            script = argv[++i];
+        } else if (arg == "--motor" && hayValor) {
+            string valor = argv[++i];
+            if (valor == "soa") motor = MOTOR_SOA;
+            else if (valor == "listas") motor = MOTOR_LISTAS;
+            else argumentosOk = false;
+        } else if (arg == "--buddy" && hayValor) {
+            argumentosOk = memoriaBuddy.iniciar(atoi(argv[++i]));
+        } else if (arg == "--planificador" && hayValor) {
+            string valor = argv[++i];
+            if (valor == "niveles") planificadorNiveles = true;
+            else if (valor == "monticulo") planificadorNiveles = false;
+            else argumentosOk = false;
+        } else if (arg == "--envejecimiento" && hayValor) {
+            envejecimiento = atoi(argv[++i]);
+            argumentosOk = envejecimiento > 0;
+        } else if (arg == "--cargar" && hayValor) {
+            cargar = argv[++i];
+        } else if (arg == "--guardar" && hayValor) {
+            guardar = argv[++i];
+        } else if (arg == "--importar" && hayValor) {
+            importar = argv[++i];
+        } else if (arg == "--wal" && hayValor) {
+            wal = argv[++i];
+        } else if (arg == "--wal-ms" && hayValor) {
+            walMs = atoi(argv[++i]);
+            argumentosOk = walMs >= 0;
+        } else {
+            argumentosOk = false;
+        }
+    }
+    // El motor SoA solo existe en el modo script y no usa el pool buddy ni
+    // la cola por niveles
+    if (motor == MOTOR_SOA && (script == NULL || memoriaBuddy.activo() || planificadorNiveles
+                               || cargar != NULL || guardar != NULL || wal != NULL || importar != NULL
+                               || envejecimiento > 0)) {
+        argumentosOk = false;
+    }
+    // La cola por niveles tiene una FIFO fija por prioridad: no envejece
+    if (envejecimiento > 0 && planificadorNiveles) argumentosOk = false;
+    if (walMs >= 0 && wal == NULL) argumentosOk = false;
+    // Lo importado no pasa por la bitcora: se guarda con --guardar
+    if (importar != NULL && wal != NULL) argumentosOk = false;
+    if (!argumentosOk) {
+        cerr << "Uso: " << argv[0] << " [--buddy <KB>] [--planificador monticulo|niveles] [--envejecimiento <E>]\n"
+             << "       [--script <archivo|-> [--motor listas|soa]]\n"
+             << "       [--cargar <archivo>] [--guardar <archivo>] [--importar <archivo>]\n"
+             << "       [--wal <archivo> [--wal-ms <N>]]\n"
+             << "     (--buddy, --planificador niveles, --envejecimiento, --cargar, --guardar, --importar\n"
+             << "      y --wal no se combinan con --motor soa; --importar tampoco con --wal,\n"
+             << "      ni --envejecimiento con --planificador niveles)\n";
+        return 2;
+    }
+    colaCPU.envejecimiento = (unsigned long long)envejecimiento;
+    bitacora.envejecimiento = (unsigned)envejecimiento;
+
+    if (cargar != NULL) {
+        const char* error = cargarInstantanea(cargar);
+        if (error != NULL) {
+            cerr << "No se pudo cargar " << cargar << ": " << error << "\n";
+            return 2;
+        }
+    }
+
+    if (importar != NULL) {
+        long long linea, filas;
+        const char* error = importarProcesos(importar, linea, filas);
+        if (error != NULL) {
+            cerr << "No se pudo importar " << importar << ", linea " << linea << ": " << error << "\n";
+            return 2;
+        }
+        cerr << "Importados " << filas << " procesos\n";
+    }
+
+    if (wal != NULL) {
+        // En los mens cada operacin se confirma antes de seguir
+        bitacora.intervaloMs = walMs >= 0 ? walMs : (script != NULL ? 10 : 0);
+        // El pool buddy puede venir de la instantnea cargada, no solo de --buddy
+        bitacora.buddyKB = memoriaBuddy.activo() ? (unsigned)memoriaBuddy.unidades : 0;
+        bitacora.niveles = planificadorNiveles ? 1 : 0;
+        long long aplicados;
+        const char* error = reproducirBitacora(wal, aplicados);
+        if (error != NULL) {
+            cerr << "No se pudo usar la bitacora " << wal << ": " << error << "\n";
+            return 2;
+        }
+        if (aplicados > 0) cerr << "Bitacora: " << aplicados << " operaciones reproducidas\n";
+    }
+
+    if (script != NULL) {
+        // Sin sincronizar con stdio ni vaciar cout en cada lectura: la salida
+        // se acumula en el bfer y se escribe en bloques grandes.
+        ios::sync_with_stdio(false);
+        cin.tie(NULL);
+
+        long errores;
+        if (string(script) == "-") {
+            errores = ejecutarScript(cin, motor);
+        } else {
+            ifstream archivo(script);
+            if (!archivo) {
+                cerr << "No se pudo abrir el script: " << script << "\n";
+                return 2;
+            }
+            errores = ejecutarScript(archivo, motor);
+        }
+        if (!guardarAlSalir(guardar)) errores++;
+        bitacora.cerrar(); // Manda al disco lo que quedaba en el bfer
+        liberarTodo();
+        return errores == 0 ? 0 : 1;
+    }
+
     int opcionPrincipal;
     do {
         system("cls || clear"); // Limpia la pantalla
@@ -555,6 +3228,7 @@ int main() {
         cout << "4. Salir\n";
         cout << "Seleccione una opcion (1-4): ";
 
+        confirmarBitacora();
         if (!(cin >> opcionPrincipal)) {
             cout << "Opcion invalida. Por favor ingrese un numero entre 1 y 4.\n";
             limpiarBuffer(); // Descarta la entrada incorrecta
@@ -583,29 +3257,12 @@ int main() {
         }
     } while (opcionPrincipal != 4);
 
-    // --- Limpieza final de memoria (Buena prctica) ---
-    // (Opcional para este ejercicio, pero importante en proyectos reales)
-    // Liberar lista de procesos
-    Proceso* procActual = cabezaProcesos;
-    while (procActual != NULL) {
-        Proceso* temp = procActual;
-        procActual = procActual->siguiente;
-        delete temp;
-    }
-    // Liberar pila de memoria
-    BloqueMemoria* memActual = topeMemoria;
-    while (memActual != NULL) {
-        BloqueMemoria* temp = memActual;
-        memActual = memActual->siguiente;
-        delete temp;
-    }
-    // Liberar cola de CPU
-    NodoCola* colaActual = cabezaCola;
-    while (colaActual != NULL) {
-        NodoCola* temp = colaActual;
-        colaActual = colaActual->siguiente;
-        delete temp;
-    }
-
-    return 0;
+#ifdef CON_METRICAS
+    imprimirMetricas(); // Lo medido durante la sesin de mens
+#endif
+    bool guardado = guardarAlSalir(guardar);
+    bitacora.cerrar();
+    liberarTodo();
+    return guardado ? 0 : 1;
 }
+#endif
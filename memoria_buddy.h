@@ -0,0 +1,222 @@
+#ifndef MEMORIA_BUDDY_H
+#define MEMORIA_BUDDY_H
+
+#include <cstddef> // NULL
+
+// Asignador buddy sobre un pool de memoria simulado (la unidad es 1 KB).
+// El pool mide 2^ordenMaximo KB. Un bloque de orden k mide 2^k KB y empieza
+// en una direccin mltiplo de 2^k; su "buddy" es el bloque del mismo orden
+// que resulta de invertir el bit k de la direccin.
+//
+// Hay una lista libre doble por orden. Reservar busca el menor orden con
+// bloques libres y parte el bloque a la mitad hasta llegar al orden pedido.
+// Liberar une el bloque con su buddy mientras este est libre y completo.
+// Las dos operaciones recorren a lo sumo ordenMaximo rdenes: O(log N).
+struct AsignadorBuddy {
+    enum { ORDENES = 31, LIBRE = 0x80 };
+
+    int ordenMaximo;       // log2 del tamao del pool (-1 = sin iniciar)
+    unsigned unidades;     // Tamao del pool en KB
+    // Datos por unidad; solo valen en la primera unidad de cada bloque
+    unsigned char* estado; // Orden del bloque | LIBRE si est en una lista libre
+    int* sigLibre;         // Enlaces de la lista libre de su orden (-1 = fin)
+    int* antLibre;
+    int primeroLibre[ORDENES];
+    unsigned libresPorOrden[ORDENES];
+
+    // Contadores para estadoMemoria
+    unsigned long long kbLibres;
+    unsigned long long kbPedidos;  // Lo que pidieron los bloques vivos
+    unsigned long long kbEntregados; // Lo que ocupan (potencias de 2)
+    long bloquesVivos;
+    long fallos; // Pedidos que no encontraron bloque
+
+    AsignadorBuddy() {
+        ordenMaximo = -1;
+        unidades = 0;
+        estado = NULL;
+        sigLibre = antLibre = NULL;
+        kbLibres = kbPedidos = kbEntregados = 0;
+        bloquesVivos = fallos = 0;
+        for (int k = 0; k < ORDENES; k++) {
+            primeroLibre[k] = -1;
+            libresPorOrden[k] = 0;
+        }
+    }
+
+    ~AsignadorBuddy() {
+        delete[] estado;
+        delete[] sigLibre;
+        delete[] antLibre;
+    }
+
+    bool activo() const {
+        return ordenMaximo >= 0;
+    }
+
+    // Menor orden cuyo bloque alcanza para 'kb' (-1 si no entra en ningn pool)
+    static int ordenPara(int kb) {
+        int k = 0;
+        while (k < ORDENES - 1 && (1 << k) < kb) k++;
+        return (1 << k) < kb ? -1 : k;
+    }
+
+    // Prepara un pool de al menos 'kb' KB (se redondea a potencia de 2)
+    // con un nico bloque libre. Borra lo que hubiera antes.
+    bool iniciar(int kb) {
+        int k = ordenPara(kb);
+        if (kb <= 0 || k < 0 || k > 30) return false;
+        delete[] estado;
+        delete[] sigLibre;
+        delete[] antLibre;
+
+        ordenMaximo = k;
+        unidades = 1u << k;
+        estado = new unsigned char[unidades]();
+        sigLibre = new int[unidades];
+        antLibre = new int[unidades];
+        for (int j = 0; j < ORDENES; j++) {
+            primeroLibre[j] = -1;
+            libresPorOrden[j] = 0;
+        }
+        kbLibres = unidades;
+        kbPedidos = kbEntregados = 0;
+        bloquesVivos = fallos = 0;
+        agregarLibre(0, k);
+        return true;
+    }
+
+    void agregarLibre(int dir, int k) {
+        estado[dir] = (unsigned char)(k | LIBRE);
+        antLibre[dir] = -1;
+        sigLibre[dir] = primeroLibre[k];
+        if (primeroLibre[k] != -1) antLibre[primeroLibre[k]] = dir;
+        primeroLibre[k] = dir;
+        libresPorOrden[k]++;
+    }
+
+    void quitarLibre(int dir, int k) {
+        if (antLibre[dir] != -1) sigLibre[antLibre[dir]] = sigLibre[dir];
+        else primeroLibre[k] = sigLibre[dir];
+        if (sigLibre[dir] != -1) antLibre[sigLibre[dir]] = antLibre[dir];
+        estado[dir] = (unsigned char)k;
+        libresPorOrden[k]--;
+    }
+
+    // Reserva un bloque para 'kb' KB. Devuelve su direccin o -1 si no hay
+    // un bloque libre lo bastante grande (aunque sobre memoria repartida).
+    int reservar(int kb) {
+        int k = ordenPara(kb);
+        int j = k;
+        if (k >= 0) {
+            while (j <= ordenMaximo && primeroLibre[j] == -1) j++;
+        }
+        if (k < 0 || j > ordenMaximo) {
+            fallos++;
+            return -1;
+        }
+
+        int dir = primeroLibre[j];
+        quitarLibre(dir, j);
+        while (j > k) { // Partir: la mitad alta queda libre
+            j--;
+            agregarLibre(dir + (1 << j), j);
+        }
+        estado[dir] = (unsigned char)k;
+
+        kbLibres -= 1u << k;
+        kbPedidos += kb;
+        kbEntregados += 1u << k;
+        bloquesVivos++;
+        return dir;
+    }
+
+    // Reserva justo el bloque de 'kb' KB que empieza en 'dir' (para
+    // reconstruir un estado guardado). Falla si 'dir' no est alineada o si
+    // ese rango no est libre.
+    bool reservarEn(int dir, int kb) {
+        int k = ordenPara(kb);
+        if (k < 0 || k > ordenMaximo || dir < 0 || (unsigned)dir >= unidades || (dir & ((1 << k) - 1)) != 0) {
+            return false;
+        }
+        // Bloque libre (del orden k o mayor) que contiene a 'dir'
+        int j = k;
+        int base = dir;
+        while (j <= ordenMaximo) {
+            base = dir & ~((1 << j) - 1);
+            if (estado[base] == (unsigned char)(j | LIBRE)) break;
+            j++;
+        }
+        if (j > ordenMaximo) return false;
+
+        quitarLibre(base, j);
+        while (j > k) { // Partir dejando libre la mitad que no contiene a 'dir'
+            j--;
+            int mitad = base + (1 << j);
+            if (dir >= mitad) {
+                agregarLibre(base, j);
+                base = mitad;
+            } else {
+                agregarLibre(mitad, j);
+            }
+        }
+        estado[dir] = (unsigned char)k;
+
+        kbLibres -= 1u << k;
+        kbPedidos += kb;
+        kbEntregados += 1u << k;
+        bloquesVivos++;
+        return true;
+    }
+
+    // Reemplaza el orden de la lista libre de orden k por el de 'dirs' (los
+    // mismos bloques, en otro orden). Falla si no son exactamente los libres.
+    bool reordenarLibres(int k, const int* dirs, int n) {
+        if (k < 0 || k > ordenMaximo || n != (int)libresPorOrden[k]) return false;
+        for (int i = 0; i < n; i++) { // Marcarlos como no libres tambin detecta repetidos
+            if (dirs[i] < 0 || (unsigned)dirs[i] >= unidades || estado[dirs[i]] != (unsigned char)(k | LIBRE)) {
+                return false;
+            }
+            estado[dirs[i]] = (unsigned char)k;
+        }
+        primeroLibre[k] = -1;
+        libresPorOrden[k] = 0;
+        for (int i = n - 1; i >= 0; i--) agregarLibre(dirs[i], k); // Cada uno queda primero
+        return true;
+    }
+
+    // Libera el bloque que empieza en 'dir' ('kb' es lo que se pidi)
+    void liberar(int dir, int kb) {
+        int k = estado[dir];
+        kbLibres += 1u << k;
+        kbPedidos -= kb;
+        kbEntregados -= 1u << k;
+        bloquesVivos--;
+
+        while (k < ordenMaximo) {
+            int buddy = dir ^ (1 << k);
+            if (estado[buddy] != (unsigned char)(k | LIBRE)) break; // Ocupado o partido
+            quitarLibre(buddy, k);
+            if (buddy < dir) dir = buddy;
+            k++;
+        }
+        agregarLibre(dir, k);
+    }
+
+    // Tamao del mayor bloque libre en KB (0 si no hay)
+    unsigned mayorLibre() const {
+        for (int k = ordenMaximo; k >= 0; k--) {
+            if (primeroLibre[k] != -1) return 1u << k;
+        }
+        return 0;
+    }
+
+    // Fragmentacin externa: qu parte de la memoria libre no est en el
+    // mayor bloque libre (0% = toda la memoria libre est junta)
+    double fragmentacion() const {
+        if (kbLibres == 0) return 0;
+        return 100.0 * (kbLibres - mayorLibre()) / kbLibres;
+    }
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <cstring> // memset
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// Histograma de valores enteros (nanosegundos o nodos visitados) con
+// cubetas logartmico-lineales, como HdrHistogram: los valores menores que
+// SUB van cada uno en su cubeta, y cada potencia de 2 por encima se parte
+// en SUB / 2 cubetas iguales. El error de un percentil es a lo sumo 1/16
+// del valor y registrar cuesta O(1) sin importar cuntas muestras haya.
+struct Histograma {
+    enum {
+        BITS_SUB = 5,
+        SUB = 1 << BITS_SUB,
+        CUBETAS = SUB + (64 - BITS_SUB) * (SUB / 2)
+    };
+
+    unsigned long long cuentas[CUBETAS];
+    unsigned long long cantidad;
+    unsigned long long suma;
+    unsigned long long maximo;
+
+    Histograma() {
+        vaciar();
+    }
+
+    void vaciar() {
+        memset(cuentas, 0, sizeof(cuentas));
+        cantidad = suma = maximo = 0;
+    }
+
+    static int bitMasAlto(unsigned long long v) { // v > 0
+#ifdef __GNUC__
+        return 63 - __builtin_clzll(v);
+#else
+        int b = 0;
+        while (v >>= 1) b++;
+        return b;
+#endif
+    }
+
+    static int cubeta(unsigned long long v) {
+        if (v < SUB) return (int)v;
+        int corrimiento = bitMasAlto(v) - (BITS_SUB - 1); // Deja BITS_SUB bits: mantisa en [SUB/2, SUB)
+        int mantisa = (int)(v >> corrimiento);
+        return SUB + (corrimiento - 1) * (SUB / 2) + (mantisa - SUB / 2);
+    }
+
+    // Mayor valor que cae en la cubeta i
+    static unsigned long long techo(int i) {
+        if (i < SUB) return (unsigned long long)i;
+        int corrimiento = (i - SUB) / (SUB / 2) + 1;
+        unsigned long long mantisa = (unsigned long long)((i - SUB) % (SUB / 2) + SUB / 2);
+        return ((mantisa + 1) << corrimiento) - 1;
+    }
+
+    void registrar(unsigned long long v) {
+        cuentas[cubeta(v)]++;
+        cantidad++;
+        suma += v;
+        if (v > maximo) maximo = v;
+    }
+
+    // Valor bajo el que queda la fraccin 'p' (0..1) de las muestras
+    unsigned long long percentil(double p) const {
+        if (cantidad == 0) return 0;
+        unsigned long long objetivo = (unsigned long long)(p * cantidad);
+        if (objetivo >= cantidad) objetivo = cantidad - 1;
+        unsigned long long vistos = 0;
+        for (int i = 0; i < CUBETAS; i++) {
+            vistos += cuentas[i];
+            if (vistos > objetivo) return techo(i) < maximo ? techo(i) : maximo;
+        }
+        return maximo;
+    }
+
+    double promedio() const {
+        return cantidad > 0 ? (double)suma / cantidad : 0;
+    }
+};
+
+inline unsigned long long relojNs() {
+#ifdef _WIN32
+    static LARGE_INTEGER frecuencia;
+    if (frecuencia.QuadPart == 0) QueryPerformanceFrequency(&frecuencia);
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return (unsigned long long)(t.QuadPart * (1000000000.0 / frecuencia.QuadPart));
+#else
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+#endif
+}
+
+// Registra en 'h' cunto vivi el objeto: se declara al principio de la
+// operacin y mide hasta cualquiera de sus return
+struct Cronometro {
+    Histograma& h;
+    unsigned long long inicio;
+
+    Cronometro(Histograma& histograma) : h(histograma) {
+        inicio = relojNs();
+    }
+
+    ~Cronometro() {
+        h.registrar(relojNs() - inicio);
+    }
+};
+
+#endif
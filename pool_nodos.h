@@ -0,0 +1,178 @@
+#ifndef POOL_NODOS_H
+#define POOL_NODOS_H
+
+#include <cstdlib> // malloc, free
+#include <new>     // placement new, bad_alloc
+#include <algorithm>  // sort
+#include <functional> // less
+#if __cplusplus >= 201103L
+#include <type_traits> // is_trivially_destructible
+#endif
+
+// true si ~T() no hace nada (sin string adentro ni destructor propio). Se
+// usa lo que ofrezca el compilador: el rasgo de C++11, el intrnseco
+// __is_trivially_destructible (clang, GCC nuevo, MSVC) o, en GCC viejo con
+// C++98, __has_trivial_destructor (clang >= 16 lo marca obsoleto). Sin
+// ninguno se supone que s hay que destruir.
+#if __cplusplus >= 201103L
+#define DESTRUCTOR_TRIVIAL(T) std::is_trivially_destructible<T>::value
+#elif defined(__has_builtin)
+#if __has_builtin(__is_trivially_destructible)
+#define DESTRUCTOR_TRIVIAL(T) __is_trivially_destructible(T)
+#endif
+#endif
+#if !defined(DESTRUCTOR_TRIVIAL) && defined(_MSC_VER)
+#define DESTRUCTOR_TRIVIAL(T) __is_trivially_destructible(T)
+#endif
+#if !defined(DESTRUCTOR_TRIVIAL) && defined(__GNUC__)
+#define DESTRUCTOR_TRIVIAL(T) __has_trivial_destructor(T)
+#endif
+#ifndef DESTRUCTOR_TRIVIAL
+#define DESTRUCTOR_TRIVIAL(T) 0
+#endif
+
+template <typename T>
+struct DestructorTrivial {
+    enum { valor = DESTRUCTOR_TRIVIAL(T) };
+};
+
+// Pool de nodos por tipo (slab allocator).
+// En vez de un new/delete por nodo, los objetos se sacan de bloques grandes
+// ("slabs") de unos 64 KB pedidos con malloc. Los nodos devueltos quedan en
+// una lista libre y se reutilizan, as que con una carga estable (altas y
+// bajas parejas) no se vuelve a llamar a malloc. Los nodos del mismo tipo
+// quedan adems juntos en memoria.
+template <typename T>
+struct PoolNodos {
+    // Una casilla guarda un T o, mientras est libre, el enlace de la lista libre
+    union Casilla {
+        Casilla* siguienteLibre;
+        unsigned char bytes[sizeof(T)];
+        double alineacion1; // Los otros miembros solo fuerzan la alineacin
+        long long alineacion2;
+        void* alineacion3;
+    };
+
+    enum { POR_SLAB = (65536 / sizeof(Casilla)) < 16 ? 16 : (65536 / sizeof(Casilla)) };
+
+    struct Slab {
+        Casilla casillas[POR_SLAB];
+        Slab* siguiente; // Slabs enlazados para poder soltarlos todos juntos
+    };
+
+    Slab* slabs;        // El ms reciente primero
+    int usadasEnActual; // Casillas ya entregadas del slab ms reciente
+    Casilla* libres;    // Lista libre (casillas devueltas)
+
+    // Contadores para verificar que no hay mallocs en estado estable
+    unsigned long long pedidos;   // Llamadas a obtener()
+    unsigned long long devueltos; // Llamadas a devolver()
+    unsigned long long mallocs;   // Slabs pedidos al sistema
+    long vivos;                   // Objetos entregados y no devueltos
+
+    PoolNodos() {
+        slabs = NULL;
+        usadasEnActual = 0;
+        libres = NULL;
+        pedidos = devueltos = mallocs = 0;
+        vivos = 0;
+    }
+
+    ~PoolNodos() {
+        liberarTodo();
+    }
+
+    // Devuelve memoria para un T sin construir
+    void* reservar() {
+        Casilla* c;
+        if (libres != NULL) {
+            c = libres;
+            libres = c->siguienteLibre;
+        } else {
+            if (slabs == NULL || usadasEnActual == POR_SLAB) nuevoSlab();
+            c = &slabs->casillas[usadasEnActual++];
+        }
+        pedidos++;
+        vivos++;
+        return c;
+    }
+
+    T* obtener() {
+        return new (reservar()) T();
+    }
+
+    template <typename A>
+    T* obtener(const A& arg) {
+        return new (reservar()) T(arg);
+    }
+
+    void devolver(T* obj) {
+        obj->~T();
+        Casilla* c = reinterpret_cast<Casilla*>(obj);
+        c->siguienteLibre = libres;
+        libres = c;
+        devueltos++;
+        vivos--;
+    }
+
+    void nuevoSlab() {
+        Slab* s = (Slab*)malloc(sizeof(Slab));
+        if (s == NULL) throw std::bad_alloc();
+        s->siguiente = slabs;
+        slabs = s;
+        usadasEnActual = 0;
+        mallocs++;
+    }
+
+    // Suelta todos los slabs de una vez. Antes destruye los objetos que
+    // sigan vivos (por ejemplo, los que tienen un string adentro); para
+    // encontrarlos marca las casillas de la lista libre. Si ~T() no hace
+    // nada (Proceso, BloqueMemoria, Nodo) ese recorrido se salta.
+    void liberarTodo() {
+        if (vivos > 0 && !DestructorTrivial<T>::valor) destruirVivos();
+        while (slabs != NULL) {
+            Slab* temp = slabs;
+            slabs = slabs->siguiente;
+            free(temp);
+        }
+        usadasEnActual = 0;
+        libres = NULL;
+        vivos = 0;
+    }
+
+    void destruirVivos() {
+        long n = 0;
+        for (Slab* s = slabs; s != NULL; s = s->siguiente) n++;
+
+        // Slabs ordenados por direccin para ubicar cada casilla libre
+        Slab** orden = new Slab*[n];
+        long i = 0;
+        for (Slab* s = slabs; s != NULL; s = s->siguiente) orden[i++] = s;
+        std::less<const void*> menor;
+        std::sort(orden, orden + n, menor);
+
+        bool* libre = new bool[n * POR_SLAB]();
+        for (Casilla* c = libres; c != NULL; c = c->siguienteLibre) {
+            long lo = 0, hi = n - 1;
+            while (lo < hi) { // ltimo slab cuya direccin es <= c
+                long mid = (lo + hi + 1) / 2;
+                if (!menor(c, orden[mid])) lo = mid;
+                else hi = mid - 1;
+            }
+            libre[lo * POR_SLAB + (c - orden[lo]->casillas)] = true;
+        }
+
+        for (long k = 0; k < n; k++) {
+            int usadas = (orden[k] == slabs) ? usadasEnActual : (int)POR_SLAB;
+            for (int j = 0; j < usadas; j++) {
+                if (!libre[k * POR_SLAB + j]) {
+                    reinterpret_cast<T*>(&orden[k]->casillas[j])->~T();
+                }
+            }
+        }
+        delete[] libre;
+        delete[] orden;
+    }
+};
+
+#endif
@@ -1,16 +1,28 @@
 #include <iostream>
 #include <string>
 #include <limits>
+#include <cmath>  // log, para las llegadas de Poisson del simulador
+#include <ctime>  // clock, para medir cunto tarda la simulacin
+#include <cstdlib> // atol, atof
+#include "../pool_nodos.h"
+#include "../tabla_nombres.h"
 using namespace std;
 // ESTRUCTURA DE UN PROCESO
 struct Proceso {
     int id;
-    string nombre;
+    unsigned nombre;  // id en tablaNombres (el texto se guarda una sola vez)
     int prioridad;
     string estado;
     int tiempoCPU;
+    int restante;       // CPU que le falta (ms); en round-robin baja de a quantum
+    long long llegada;  // Reloj virtual (ms): cundo entr a la cola de listos
+    long long inicio;   // Cundo tom la CPU
+    long long fin;      // Cundo termin
 };
 
+// NOMBRES INTERNADOS: procesos con el mismo nombre comparten el texto
+TablaNombres tablaNombres;
+
 // ESTRUCTURA DE UN NODO (usa puntero al siguiente)
 struct Nodo {
     Proceso *data;    // puntero al proceso (no copia)
@@ -21,6 +33,43 @@ struct Nodo {
         sig = NULL;
     }
 };
+// POOL DE NODOS: Cola, Pila y Lista sacan sus nodos de slabs compartidos
+// en vez de hacer un new/delete por cada nodo
+PoolNodos<Nodo> poolNodos;
+// MOSTRAR POR PGINAS: con millones de procesos imprimir todo de una vez
+// tarda minutos, as que las estructuras se muestran de a TAM_PAGINA nodos
+// y se pregunta si seguir. Cada pgina cuesta lo que muestra.
+const int TAM_PAGINA = 20;
+
+// Imprime hasta 'limite' procesos desde 'aux' y devuelve el nodo siguiente
+// al ltimo mostrado (NULL si no quedan)
+Nodo *imprimirNodos(Nodo *aux, int limite) {
+    for (int k = 0; aux != NULL && k < limite; k++) {
+        cout << "ID: " << aux->data->id
+             << " | Nombre: " << tablaNombres.texto(aux->data->nombre)
+             << " | Prioridad: " << aux->data->prioridad
+             << " | Estado: " << aux->data->estado
+             << " | Tiempo CPU: " << aux->data->tiempoCPU << " ms";
+        if (aux->data->restante > 0 && aux->data->restante < aux->data->tiempoCPU)
+            cout << " | Restante: " << aux->data->restante << " ms";
+        cout << "\n";
+        aux = aux->sig;
+    }
+    return aux;
+}
+
+// Lee la respuesta con getline: el men ya descart el Enter de la opcin
+bool seguirPaginando() {
+    cout << "-- Enter: siguiente pagina, q + Enter: volver -- ";
+    string respuesta;
+    if (!getline(cin, respuesta)) return false;
+    return respuesta.empty() || (respuesta[0] != 'q' && respuesta[0] != 'Q');
+}
+
+void mostrarPaginado(Nodo *aux) {
+    while ((aux = imprimirNodos(aux, TAM_PAGINA)) != NULL && seguirPaginando()) {
+    }
+}
 // CLASE COLA (READY QUEUE)
 struct Cola {
     Nodo *frente; // puntero al primer nodo
@@ -36,7 +85,7 @@ struct Cola {
     }
 
     void encolar(Proceso *p) {
-        Nodo *nuevo = new Nodo(p);
+        Nodo *nuevo = poolNodos.obtener(p);
         if (fin == NULL) {
             frente = fin = nuevo;
         } else {
@@ -51,10 +100,29 @@ struct Cola {
         p = frente->data; // el puntero p apunta al proceso del nodo
         frente = frente->sig;
         if (frente == NULL) fin = NULL;
-        delete temp; // liberamos el nodo, no el proceso
+        poolNodos.devolver(temp); // devolvemos el nodo al pool, no el proceso
         return true;
     }
 
+    // Pasa el primero al final reenlazando el mismo nodo: O(1), sin pool
+    void rotar() {
+        if (frente == fin) return;
+        Nodo *primero = frente;
+        frente = primero->sig;
+        primero->sig = NULL;
+        fin->sig = primero;
+        fin = primero;
+    }
+
+    // Desengancha el primer nodo sin devolverlo (para pasarlo a la pila)
+    Nodo *sacarNodo() {
+        Nodo *primero = frente;
+        frente = primero->sig;
+        if (frente == NULL) fin = NULL;
+        primero->sig = NULL;
+        return primero;
+    }
+
     void mostrar() {
         if (vacia()) {
             cout << "\n[Cola vacia]\n";
@@ -62,14 +130,7 @@ struct Cola {
         }
         Nodo *aux = frente;
         cout << "\n--- COLA DE EJECUCION (READY QUEUE) ---\n";
-        while (aux != NULL) {
-            cout << "ID: " << aux->data->id
-                 << " | Nombre: " << aux->data->nombre
-                 << " | Prioridad: " << aux->data->prioridad
-                 << " | Estado: " << aux->data->estado
-                 << " | Tiempo CPU: " << aux->data->tiempoCPU << " ms\n";
-            aux = aux->sig;
-        }
+        mostrarPaginado(aux);
     }
 };
 // CLASE PILA (PROCESOS FINALIZADOS)
@@ -85,17 +146,23 @@ struct Pila {
     }
 
     void push(Proceso *p) {
-        Nodo *nuevo = new Nodo(p);
+        Nodo *nuevo = poolNodos.obtener(p);
         nuevo->sig = tope;
         tope = nuevo;
     }
 
+    // Apila un nodo que ya sali de otra estructura (no pide uno nuevo al pool)
+    void pushNodo(Nodo *nodo) {
+        nodo->sig = tope;
+        tope = nodo;
+    }
+
     bool pop(Proceso *&p) {
         if (vacia()) return false;
         Nodo *temp = tope;
         p = tope->data;
         tope = tope->sig;
-        delete temp;
+        poolNodos.devolver(temp);
         return true;
     }
 
@@ -106,14 +173,7 @@ struct Pila {
         }
         Nodo *aux = tope;
         cout << "\n--- PILA DE FINALIZADOS ---\n";
-        while (aux != NULL) {
-            cout << "ID: " << aux->data->id
-                 << " | Nombre: " << aux->data->nombre
-                 << " | Prioridad: " << aux->data->prioridad
-                 << " | Estado: " << aux->data->estado
-                 << " | Tiempo CPU: " << aux->data->tiempoCPU << " ms\n";
-            aux = aux->sig;
-        }
+        mostrarPaginado(aux);
     }
 };
 // CLASE LISTA (TODOS LOS PROCESOS)
@@ -125,7 +185,7 @@ struct Lista {
     }
 
     void insertarFinal(Proceso *p) {
-        Nodo *nuevo = new Nodo(p);
+        Nodo *nuevo = poolNodos.obtener(p);
         if (inicio == NULL) {
             inicio = nuevo;
         } else {
@@ -142,16 +202,616 @@ struct Lista {
         }
         Nodo *aux = inicio;
         cout << "\n--- LISTA DE PROCESOS CREADOS ---\n";
-        while (aux != NULL) {
-            cout << "ID: " << aux->data->id
-                 << " | Nombre: " << aux->data->nombre
-                 << " | Prioridad: " << aux->data->prioridad
-                 << " | Estado: " << aux->data->estado
-                 << " | Tiempo CPU: " << aux->data->tiempoCPU << " ms\n";
-            aux = aux->sig;
+        mostrarPaginado(aux);
+    }
+};
+// COLA DE EVENTOS (MONTICULO 4-ARIO EN UN ARREGLO)
+// El simulador saca siempre el evento ms prximo. Con 4 hijos por nodo el
+// montculo es ms bajo que uno binario y cada nivel revisa hijos contiguos
+// en memoria. A igual tiempo sale primero el evento programado antes.
+enum TipoEvento {
+    EVENTO_LLEGADA,   // El proceso entra a la cola de listos
+    EVENTO_DESPACHO,  // Una CPU libre toma el primero de la cola
+    EVENTO_FIN        // El proceso termina su rfaga y libera la CPU
+};
+
+struct Evento {
+    long long tiempo;              // Reloj virtual (ms)
+    unsigned long long secuencia;  // Desempate FIFO entre eventos simultneos
+    int tipo;
+    Proceso *proceso;
+};
+
+struct ColaEventos {
+    Evento *eventos;
+    int cantidad;
+    int capacidad;
+    unsigned long long programados;
+
+    ColaEventos() {
+        capacidad = 64;
+        cantidad = 0;
+        programados = 0;
+        eventos = new Evento[capacidad];
+    }
+
+    ~ColaEventos() {
+        delete[] eventos;
+    }
+
+    bool vacia() {
+        return cantidad == 0;
+    }
+
+    static bool antes(const Evento &a, const Evento &b) {
+        if (a.tiempo != b.tiempo) return a.tiempo < b.tiempo;
+        return a.secuencia < b.secuencia;
+    }
+
+    void programar(long long tiempo, int tipo, Proceso *p) {
+        if (cantidad == capacidad) {
+            Evento *nuevo = new Evento[capacidad * 2];
+            for (int i = 0; i < cantidad; i++) nuevo[i] = eventos[i];
+            delete[] eventos;
+            eventos = nuevo;
+            capacidad *= 2;
+        }
+        Evento e;
+        e.tiempo = tiempo;
+        e.secuencia = programados++;
+        e.tipo = tipo;
+        e.proceso = p;
+
+        int i = cantidad++;
+        while (i > 0) { // Subir
+            int padre = (i - 1) / 4;
+            if (!antes(e, eventos[padre])) break;
+            eventos[i] = eventos[padre];
+            i = padre;
+        }
+        eventos[i] = e;
+    }
+
+    Evento extraer() {
+        Evento primero = eventos[0];
+        Evento ultimo = eventos[--cantidad];
+        int i = 0;
+        while (true) { // Bajar el ltimo desde la raz
+            int hijo = 4 * i + 1;
+            if (hijo >= cantidad) break;
+            int fin = hijo + 4 < cantidad ? hijo + 4 : cantidad;
+            int menor = hijo;
+            for (int j = hijo + 1; j < fin; j++) {
+                if (antes(eventos[j], eventos[menor])) menor = j;
+            }
+            if (!antes(eventos[menor], ultimo)) break;
+            eventos[i] = eventos[menor];
+            i = menor;
+        }
+        if (cantidad > 0) eventos[i] = ultimo;
+        return primero;
+    }
+};
+
+// SIMULADOR DE EVENTOS DISCRETOS
+// Varias CPU atienden la cola de listos (Cola, FIFO). El reloj salta de
+// evento en evento, as que el costo depende de la cantidad de eventos y no
+// de los milisegundos simulados. Las llegadas sintticas se generan de a una
+// (cada llegada programa la siguiente), por eso el montculo nunca tiene ms
+// de CPUs + 1 eventos aunque se simulen millones de procesos.
+struct ResultadoSimulacion {
+    long procesos;
+    long long makespan;         // Fin del ltimo proceso (ms desde t = 0)
+    double esperaPromedio;      // Despacho - llegada
+    double retornoPromedio;     // Fin - llegada
+    double utilizacion;         // Tiempo ocupado / (CPUs * makespan)
+    long maxEnCola;
+    unsigned long long eventos;
+    double segundosReales;
+};
+
+// Generador de la carga sinttica (xorshift64*, reproducible con la semilla)
+struct GeneradorCarga {
+    unsigned long long estado;
+
+    GeneradorCarga(unsigned long long semilla) {
+        estado = semilla ? semilla : 88172645463325252ULL;
+    }
+
+    double uniforme() { // En (0, 1]
+        estado ^= estado >> 12;
+        estado ^= estado << 25;
+        estado ^= estado >> 27;
+        return ((estado * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0) + 1e-17;
+    }
+
+    // Exponencial de media 'media' redondeada a ms (al menos 'minimo')
+    long long exponencial(double media, long long minimo) {
+        long long x = (long long)(-log(uniforme()) * media + 0.5);
+        return x < minimo ? minimo : x;
+    }
+};
+
+struct Simulador {
+    int cpus;
+    int cpusLibres;
+    long long reloj;
+    Cola listos;
+    ColaEventos eventos;
+    Pila *terminados;        // Si no es NULL, los procesos terminados se apilan aqu
+
+    // Carga sinttica: 'pendientes' procesos ms por llegar
+    Proceso *sinteticos;
+    long pendientes;
+    long generados;
+    double llegadaMedia;
+    double cpuMedio;
+    GeneradorCarga *generador;
+
+    // Acumuladores
+    long terminadosCant;
+    long enCola;      // Procesos en la cola de listos
+    long sinCpu;      // De esos, cuntos todava no tienen un despacho programado
+    long maxEnCola;
+    long long esperaTotal;
+    long long retornoTotal;
+    long long ocupadoTotal;
+
+    Simulador(int cantidadCpus) {
+        cpus = cpusLibres = cantidadCpus;
+        reloj = 0;
+        terminados = NULL;
+        sinteticos = NULL;
+        pendientes = generados = 0;
+        llegadaMedia = cpuMedio = 0;
+        generador = NULL;
+        terminadosCant = enCola = sinCpu = maxEnCola = 0;
+        esperaTotal = retornoTotal = ocupadoTotal = 0;
+    }
+
+    void llegar(Proceso *p) {
+        p->llegada = reloj;
+        p->estado = "Listo";
+        listos.encolar(p);
+        if (++enCola > maxEnCola) maxEnCola = enCola;
+        sinCpu++;
+        intentarDespachar();
+    }
+
+    // Reserva una CPU libre para el primero de la cola que no tenga una
+    void intentarDespachar() {
+        if (cpusLibres > 0 && sinCpu > 0) {
+            cpusLibres--;
+            sinCpu--;
+            eventos.programar(reloj, EVENTO_DESPACHO, NULL);
+        }
+    }
+
+    void siguienteSintetico() {
+        Proceso *p = &sinteticos[generados++];
+        p->id = (int)generados;
+        p->tiempoCPU = p->restante = (int)generador->exponencial(cpuMedio, 1);
+        long long cuando = reloj + (generados == 1 ? 0 : generador->exponencial(llegadaMedia, 0));
+        eventos.programar(cuando, EVENTO_LLEGADA, p);
+        pendientes--;
+    }
+
+    void procesar(const Evento &e) {
+        reloj = e.tiempo;
+        switch (e.tipo) {
+            case EVENTO_LLEGADA:
+                llegar(e.proceso);
+                if (pendientes > 0) siguienteSintetico();
+                break;
+            case EVENTO_DESPACHO: {
+                Proceso *p = NULL;
+                listos.desencolar(p); // Hay uno seguro: sinCpu se descont al programar
+                enCola--;
+                p->inicio = reloj;
+                p->estado = "Ejecutando";
+                esperaTotal += reloj - p->llegada;
+                // Lo que le falta: pudo haber corrido turnos de round-robin
+                eventos.programar(reloj + p->restante, EVENTO_FIN, p);
+                break;
+            }
+            case EVENTO_FIN: {
+                Proceso *p = e.proceso;
+                p->fin = reloj;
+                p->estado = "Finalizado";
+                retornoTotal += reloj - p->llegada;
+                ocupadoTotal += p->restante;
+                p->restante = 0;
+                terminadosCant++;
+                if (terminados != NULL) terminados->push(p);
+                cpusLibres++;
+                intentarDespachar();
+                break;
+            }
         }
     }
+
+    ResultadoSimulacion correr() {
+        clock_t inicio = clock();
+        while (!eventos.vacia()) procesar(eventos.extraer());
+
+        ResultadoSimulacion r;
+        r.procesos = terminadosCant;
+        r.makespan = reloj;
+        r.esperaPromedio = terminadosCant ? (double)esperaTotal / terminadosCant : 0;
+        r.retornoPromedio = terminadosCant ? (double)retornoTotal / terminadosCant : 0;
+        r.utilizacion = reloj > 0 ? (double)ocupadoTotal / ((double)cpus * reloj) : 0;
+        r.maxEnCola = maxEnCola;
+        r.eventos = eventos.programados;
+        r.segundosReales = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+        return r;
+    }
+};
+
+// Simula los procesos que estn en la cola: todos llegan en t = 0 (en el
+// orden de la cola) y los terminados pasan a la pila de finalizados.
+ResultadoSimulacion simularCola(Cola &cola, Pila &pila, int cpus) {
+    Simulador sim(cpus);
+    sim.terminados = &pila;
+    Proceso *p;
+    while (cola.desencolar(p)) sim.llegar(p);
+    return sim.correr();
+}
+
+// Simula 'n' procesos sintticos con llegadas de Poisson (media entre
+// llegadas 'llegadaMedia' ms) y rfagas exponenciales de media 'cpuMedio' ms.
+ResultadoSimulacion simularCarga(long n, int cpus, double llegadaMedia, double cpuMedio,
+                                 unsigned long long semilla) {
+    Simulador sim(cpus);
+    GeneradorCarga generador(semilla);
+    unsigned nombre = tablaNombres.internar("sintetico");
+    sim.sinteticos = new Proceso[n];
+    for (long i = 0; i < n; i++) {
+        sim.sinteticos[i].nombre = nombre;
+        sim.sinteticos[i].prioridad = 1;
+    }
+    sim.pendientes = n;
+    sim.llegadaMedia = llegadaMedia;
+    sim.cpuMedio = cpuMedio;
+    sim.generador = &generador;
+    if (n > 0) sim.siguienteSintetico();
+    ResultadoSimulacion r = sim.correr();
+    tablaNombres.soltar(nombre);
+    delete[] sim.sinteticos;
+    return r;
+}
+
+void imprimirSimulacion(const ResultadoSimulacion &r, int cpus) {
+    cout << "\n--- RESULTADO DE LA SIMULACION (" << cpus << " CPU) ---\n"
+         << "Procesos terminados: " << r.procesos << "\n"
+         << "Makespan: " << r.makespan << " ms\n"
+         << "Espera promedio: " << r.esperaPromedio << " ms\n"
+         << "Retorno promedio: " << r.retornoPromedio << " ms\n"
+         << "Utilizacion de CPU: " << r.utilizacion * 100 << " %\n"
+         << "Maximo en cola: " << r.maxEnCola << "\n"
+         << "Eventos: " << r.eventos << " en " << r.segundosReales << " s reales\n";
+}
+
+// ROUND-ROBIN CON QUANTUM (UNA CPU)
+// En cada turno el primero de la cola usa min(quantum, restante) ms. Si no
+// termin, su mismo nodo pasa al final (Cola::rotar) y si termin el nodo se
+// mueve tal cual a la pila de finalizados: un turno no pide ni devuelve
+// nodos al pool.
+struct ResultadoRoundRobin {
+    long procesos;
+    long long turnos;           // Quantums asignados, incluidos los adelantados
+    long long turnosSimulados;  // Los que se hicieron de a uno
+    long long makespan;         // Reloj al terminar el ltimo
+    double retornoPromedio;     // Fin - llegada
+    double segundosReales;
 };
+
+// Un turno del primero de la cola (que no puede estar vaca). true si termin.
+bool turnoRoundRobin(Cola &cola, Pila &pila, int quantum, long long &reloj) {
+    Proceso *p = cola.frente->data;
+    if (p->restante == p->tiempoCPU) p->inicio = reloj; // Primer turno
+    int uso = p->restante < quantum ? p->restante : quantum;
+    reloj += uso;
+    p->restante -= uso;
+    if (p->restante > 0) {
+        p->estado = "Listo";
+        cola.rotar();
+        return false;
+    }
+    p->fin = reloj;
+    p->estado = "Finalizado";
+    pila.pushNodo(cola.sacarNodo());
+    return true;
+}
+
+// Corre la cola hasta vaciarla. Con 'adelantar', antes de cada ronda se
+// busca cuntas rondas completas pueden pasar sin que nadie termine (todos
+// usan el quantum entero, as que el orden no cambia) y se descuentan de una
+// vez: cada pasada por la cola termina al menos un proceso, y el costo ya
+// no depende de los milisegundos simulados sino de la cantidad de procesos.
+ResultadoRoundRobin ejecutarRoundRobin(Cola &cola, Pila &pila, int quantum, long long &reloj, bool adelantar) {
+    ResultadoRoundRobin r;
+    r.procesos = 0;
+    r.turnos = r.turnosSimulados = 0;
+    long long retornoTotal = 0;
+    clock_t inicio = clock();
+    while (!cola.vacia()) {
+        long vivos = 0;
+        long long rondas = -1;
+        for (Nodo *n = cola.frente; n != NULL; n = n->sig) {
+            int resta = n->data->restante;
+            long long antesDelUltimo = resta > 0 ? (resta - 1) / quantum : 0;
+            if (rondas < 0 || antesDelUltimo < rondas) rondas = antesDelUltimo;
+            vivos++;
+        }
+        if (adelantar && rondas > 0) {
+            long long posicion = 0;
+            for (Nodo *n = cola.frente; n != NULL; n = n->sig, posicion++) {
+                Proceso *p = n->data;
+                if (p->restante == p->tiempoCPU) p->inicio = reloj + posicion * quantum;
+                p->restante -= (int)(rondas * quantum);
+            }
+            reloj += rondas * quantum * vivos;
+            r.turnos += rondas * vivos;
+        }
+        // Una ronda de a un turno (sin adelantar, la cola entera se recorre as)
+        for (long i = 0; i < vivos; i++) {
+            if (turnoRoundRobin(cola, pila, quantum, reloj)) {
+                r.procesos++;
+                retornoTotal += pila.tope->data->fin - pila.tope->data->llegada;
+            }
+        }
+        r.turnos += vivos;
+        r.turnosSimulados += vivos;
+    }
+    r.makespan = reloj;
+    r.retornoPromedio = r.procesos ? (double)retornoTotal / r.procesos : 0;
+    r.segundosReales = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+    return r;
+}
+
+// Corre en round-robin 'n' procesos sintticos que llegan todos en t = 0,
+// con rfagas exponenciales de media 'cpuMedio' ms
+ResultadoRoundRobin simularRoundRobin(long n, int quantum, double cpuMedio, unsigned long long semilla,
+                                      bool adelantar) {
+    GeneradorCarga generador(semilla);
+    unsigned nombre = tablaNombres.internar("sintetico");
+    Proceso *procesos = new Proceso[n];
+    Cola cola;
+    Pila pila;
+    for (long i = 0; i < n; i++) {
+        long long cpu = generador.exponencial(cpuMedio, 1);
+        procesos[i].id = (int)(i + 1);
+        procesos[i].nombre = nombre;
+        procesos[i].prioridad = 1;
+        procesos[i].estado = "Listo";
+        procesos[i].tiempoCPU = procesos[i].restante = cpu > 2147483647LL ? 2147483647 : (int)cpu;
+        procesos[i].llegada = 0;
+        cola.encolar(&procesos[i]);
+    }
+    long long reloj = 0;
+    ResultadoRoundRobin r = ejecutarRoundRobin(cola, pila, quantum, reloj, adelantar);
+    Proceso *p;
+    while (pila.pop(p)) {
+    }
+    tablaNombres.soltar(nombre);
+    delete[] procesos;
+    return r;
+}
+
+void imprimirRoundRobin(const ResultadoRoundRobin &r, int quantum) {
+    cout << "\n--- RESULTADO DEL ROUND-ROBIN (quantum " << quantum << " ms) ---\n"
+         << "Procesos terminados: " << r.procesos << "\n"
+         << "Makespan: " << r.makespan << " ms\n"
+         << "Retorno promedio: " << r.retornoPromedio << " ms\n"
+         << "Turnos: " << r.turnos << " (" << r.turnosSimulados << " de a uno) en "
+         << r.segundosReales << " s reales\n";
+}
+#ifdef CON_HILOS
+// EJECUCION EN PARALELO (HILOS REALES CON ROBO DE TRABAJO)
+// Cada ncleo es un hilo con su propia cola local (un deque de Chase-Lev):
+// saca sus procesos por abajo sin bloqueos y, cuando se queda sin trabajo,
+// roba por arriba de la cola de otro ncleo elegido al azar. No hay una
+// cola global que todos tengan que tomar por turnos.
+//
+// Necesita C++11 e hilos, as que solo se compila con CON_HILOS:
+//     g++ -O2 -std=c++11 -pthread -DCON_HILOS main.cpp
+// (El MinGW del proyecto de Dev-C++ no trae std::thread.)
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "../deque_robo.h"
+
+struct Nucleo {
+    DequeRobo<Proceso *> cola;
+    long ejecutados;
+    long robados;
+    unsigned long long semilla;  // Para elegir a quin robar
+    unsigned long long trabajo;  // Resultado del trabajo simulado (para que no se optimice)
+    vector<Proceso *> terminados;
+
+    Nucleo() {
+        ejecutados = robados = 0;
+        semilla = 1;
+        trabajo = 0;
+    }
+};
+
+struct ResultadoParalelo {
+    long procesos;
+    int hilos;
+    double segundos;
+    long robos;
+    long minPorNucleo;
+    long maxPorNucleo;
+};
+
+// Trabajo simulado: tiempoCPU * trabajoPorMs vueltas de un hash barato
+unsigned long long ejecutarTrabajo(const Proceso *p, long trabajoPorMs) {
+    unsigned long long h = (unsigned long long)p->id;
+    long vueltas = (long)p->tiempoCPU * trabajoPorMs;
+    for (long i = 0; i < vueltas; i++) h = h * 6364136223846793005ULL + 1442695040888963407ULL;
+    return h;
+}
+
+void correrNucleo(Nucleo *nucleos, int hilos, int yo, atomic<long> *restantes, long trabajoPorMs) {
+    Nucleo &n = nucleos[yo];
+    while (restantes->load(memory_order_acquire) > 0) {
+        Proceso *p = n.cola.sacar();
+        if (p == NULL && hilos > 1) {
+            // Sin trabajo local: probar con los dems desde uno al azar
+            n.semilla = n.semilla * 6364136223846793005ULL + 1442695040888963407ULL;
+            int inicio = (int)((n.semilla >> 33) % (unsigned)(hilos - 1));
+            for (int k = 0; k < hilos - 1 && p == NULL; k++) {
+                int victima = (yo + 1 + (inicio + k) % (hilos - 1)) % hilos;
+                p = nucleos[victima].cola.robar();
+            }
+            if (p != NULL) n.robados++;
+        }
+        if (p == NULL) {
+            this_thread::yield(); // Quedan procesos, pero los tiene otro ncleo en la mano
+            continue;
+        }
+        n.trabajo += ejecutarTrabajo(p, trabajoPorMs);
+        p->estado = "Finalizado";
+        n.terminados.push_back(p);
+        n.ejecutados++;
+        restantes->fetch_sub(1, memory_order_acq_rel);
+    }
+}
+
+// Ejecuta los procesos en 'hilos' hilos. Si 'repartir' es true se reparten
+// en ronda entre los ncleos; si no, todos arrancan en el ncleo 0 y el
+// resto del trabajo llega solo robando. Los terminados quedan en
+// 'terminados' en el orden en que cada ncleo los fue terminando.
+ResultadoParalelo ejecutarEnParalelo(Proceso **procesos, long n, int hilos, long trabajoPorMs,
+                                     bool repartir, vector<Proceso *> &terminados) {
+    Nucleo *nucleos = new Nucleo[hilos];
+    for (int i = 0; i < hilos; i++) nucleos[i].semilla = 0x9E3779B97F4A7C15ULL * (i + 1);
+    // Antes de lanzar los hilos cualquiera puede apilar; despus, solo el dueo
+    for (long i = 0; i < n; i++) nucleos[repartir ? i % hilos : 0].cola.apilar(procesos[i]);
+
+    atomic<long> restantes(n);
+    chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+    vector<thread> trabajadores;
+    for (int i = 0; i < hilos; i++) {
+        trabajadores.push_back(thread(correrNucleo, nucleos, hilos, i, &restantes, trabajoPorMs));
+    }
+    for (int i = 0; i < hilos; i++) trabajadores[i].join();
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    ResultadoParalelo r;
+    r.procesos = n;
+    r.hilos = hilos;
+    r.segundos = segundos;
+    r.robos = 0;
+    r.minPorNucleo = n;
+    r.maxPorNucleo = 0;
+    unsigned long long sumidero = 0;
+    for (int i = 0; i < hilos; i++) {
+        r.robos += nucleos[i].robados;
+        if (nucleos[i].ejecutados < r.minPorNucleo) r.minPorNucleo = nucleos[i].ejecutados;
+        if (nucleos[i].ejecutados > r.maxPorNucleo) r.maxPorNucleo = nucleos[i].ejecutados;
+        terminados.insert(terminados.end(), nucleos[i].terminados.begin(), nucleos[i].terminados.end());
+        sumidero ^= nucleos[i].trabajo;
+    }
+    if (sumidero == 42) cout << ""; // Usa el resultado del trabajo simulado
+    delete[] nucleos;
+    return r;
+}
+
+void imprimirParalelo(const ResultadoParalelo &r) {
+    cout << "\n--- EJECUCION EN PARALELO (" << r.hilos << " hilos, "
+         << thread::hardware_concurrency() << " nucleos en la maquina) ---\n"
+         << "Procesos ejecutados: " << r.procesos << "\n"
+         << "Tiempo real: " << r.segundos << " s\n"
+         << "Despachos por segundo: " << (r.segundos > 0 ? r.procesos / r.segundos : 0) << "\n"
+         << "Robos: " << r.robos << "\n"
+         << "Procesos por nucleo: min " << r.minPorNucleo << ", max " << r.maxPorNucleo << "\n";
+}
+
+// COLA DE LISTOS COMPARTIDA (PRODUCTORES Y CONSUMIDORES)
+// Cuando varios hilos crean procesos y varios los ejecutan, todos usan la
+// misma cola de listos. ColaMPMC lo hace sin bloqueos; ColaConMutex es la
+// Cola de siempre con un mutex, que pone en fila a todos los hilos (y
+// protege tambin al pool de nodos, que no es seguro entre hilos).
+#include <mutex>
+#include "../cola_mpmc.h"
+
+struct ColaConMutex {
+    Cola cola;
+    mutex m;
+
+    bool encolar(Proceso *p) {
+        lock_guard<mutex> g(m);
+        cola.encolar(p);
+        return true;
+    }
+
+    bool desencolar(Proceso *&p) {
+        lock_guard<mutex> g(m);
+        return cola.desencolar(p);
+    }
+};
+
+// Los productores se reparten 'procesos' en tramos y los encolan; si la
+// cola est llena ceden el turno y reintentan. Los consumidores desencolan
+// y ejecutan hasta que no queda ninguno por terminar.
+template <typename C>
+void producir(C *cola, Proceso *procesos, long desde, long hasta) {
+    for (long i = desde; i < hasta; i++) {
+        while (!cola->encolar(&procesos[i])) this_thread::yield();
+    }
+}
+
+template <typename C>
+void consumir(C *cola, atomic<long> *restantes, long trabajoPorMs, Nucleo *yo) {
+    Proceso *p;
+    while (restantes->load(memory_order_acquire) > 0) {
+        if (!cola->desencolar(p)) {
+            this_thread::yield();
+            continue;
+        }
+        yo->trabajo += ejecutarTrabajo(p, trabajoPorMs);
+        p->estado = "Finalizado";
+        yo->ejecutados++;
+        restantes->fetch_sub(1, memory_order_acq_rel);
+    }
+}
+
+template <typename C>
+ResultadoParalelo ejecutarConProductores(C &cola, Proceso *procesos, long n, int productores,
+                                         int consumidores, long trabajoPorMs) {
+    Nucleo *nucleos = new Nucleo[consumidores];
+    atomic<long> restantes(n);
+    chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+    vector<thread> hilos;
+    for (int i = 0; i < consumidores; i++) {
+        hilos.push_back(thread(consumir<C>, &cola, &restantes, trabajoPorMs, &nucleos[i]));
+    }
+    for (int i = 0; i < productores; i++) {
+        hilos.push_back(thread(producir<C>, &cola, procesos, n * i / productores, n * (i + 1) / productores));
+    }
+    for (size_t i = 0; i < hilos.size(); i++) hilos[i].join();
+
+    ResultadoParalelo r;
+    r.procesos = n;
+    r.hilos = productores + consumidores;
+    r.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    r.robos = 0;
+    r.minPorNucleo = n;
+    r.maxPorNucleo = 0;
+    unsigned long long sumidero = 0;
+    for (int i = 0; i < consumidores; i++) {
+        if (nucleos[i].ejecutados < r.minPorNucleo) r.minPorNucleo = nucleos[i].ejecutados;
+        if (nucleos[i].ejecutados > r.maxPorNucleo) r.maxPorNucleo = nucleos[i].ejecutados;
+        sumidero ^= nucleos[i].trabajo;
+    }
+    if (sumidero == 42) cout << "";
+    delete[] nucleos;
+    return r;
+}
+#endif
+
 // FUNCIONES AUXILIARES
 int generarID() {
     static int id = 1;
@@ -164,21 +824,137 @@ void pausa() {
     cin.get();
 }
 
+// Como pausa(), cuando el Enter de la opcin ya se ley (despus de mostrar)
+void pausaSinLimpiar() {
+    cout << "\nPresione ENTER para continuar...";
+    cin.get();
+}
+
 void menu() {
     cout << "\n SISTEMA DE GESTION DE PROCESOS (SIMULADOR)";
     cout << "\n1. Crear nuevo proceso";
-    cout << "\n2. Ejecutar proceso (CPU)";
+    cout << "\n2. Ejecutar proceso (CPU; un quantum si hay round-robin)";
     cout << "\n3. Mostrar lista de procesos";
     cout << "\n4. Mostrar cola de ejecucion";
     cout << "\n5. Mostrar pila de finalizados";
+    cout << "\n6. Estadisticas del pool de nodos";
+    cout << "\n7. Simular la cola con varias CPU (eventos discretos)";
+    cout << "\n8. Simular una carga sintetica";
+#ifdef CON_HILOS
+    cout << "\n9. Ejecutar la cola en paralelo (hilos con robo de trabajo)";
+#endif
+    cout << "\n10. Configurar quantum (round-robin)";
+    cout << "\n11. Ejecutar toda la cola en round-robin";
     cout << "\n0. Salir";
     cout << "\nSeleccione una opcion: ";
 }
+// (benchmark/ incluye este archivo con SIN_MAIN definido)
+#ifndef SIN_MAIN
 // FUNCIN PRINCIPAL
-int main() {
+// Uso: sin argumentos abre el men.
+//      --simular <procesos> <cpus> <llegada_media_ms> <cpu_medio_ms> [semilla]
+//          corre una carga sinttica, imprime el resultado y termina
+//      --paralelo <procesos> <hilos> [trabajo_por_ms] [repartido|uno]
+//          (solo con CON_HILOS) ejecuta procesos sintticos en hilos reales
+//      --productores <procesos> <productores> <consumidores> [trabajo_por_ms] [mpmc|mutex]
+//          (solo con CON_HILOS) unos hilos crean procesos y otros los
+//          ejecutan, compartiendo una cola de listos
+//      --round-robin <procesos> <quantum> <cpu_medio_ms> [semilla] [adelantar|paso]
+//          corre en round-robin procesos sintticos que llegan en t = 0;
+//          'paso' hace los turnos de a uno (para comparar con 'adelantar')
+int main(int argc, char *argv[]) {
+#ifdef CON_HILOS
+    if (argc > 1 && string(argv[1]) == "--paralelo") {
+        string inicial = argc > 5 ? argv[5] : "repartido";
+        if (argc < 4 || atol(argv[2]) < 0 || atoi(argv[3]) <= 0 || (argc > 4 && atol(argv[4]) < 0)
+            || (inicial != "repartido" && inicial != "uno")) {
+            cerr << "Uso: " << argv[0] << " --paralelo <procesos> <hilos> [trabajo_por_ms] [repartido|uno]\n";
+            return 2;
+        }
+        long n = atol(argv[2]);
+        Proceso *procesos = new Proceso[n];
+        Proceso **punteros = new Proceso *[n];
+        unsigned nombre = tablaNombres.internar("paralelo");
+        GeneradorCarga generador(1);
+        for (long i = 0; i < n; i++) {
+            procesos[i].id = (int)(i + 1);
+            procesos[i].nombre = nombre;
+            procesos[i].prioridad = 1;
+            procesos[i].estado = "Listo";
+            procesos[i].tiempoCPU = 1 + (int)(generador.uniforme() * 100);
+            punteros[i] = &procesos[i];
+        }
+        vector<Proceso *> terminados;
+        imprimirParalelo(ejecutarEnParalelo(punteros, n, atoi(argv[3]), argc > 4 ? atol(argv[4]) : 10,
+                                            inicial == "repartido", terminados));
+        delete[] punteros;
+        delete[] procesos;
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--productores") {
+        string tipo = argc > 6 ? argv[6] : "mpmc";
+        if (argc < 5 || atol(argv[2]) < 0 || atoi(argv[3]) <= 0 || atoi(argv[4]) <= 0
+            || (argc > 5 && atol(argv[5]) < 0) || (tipo != "mpmc" && tipo != "mutex")) {
+            cerr << "Uso: " << argv[0]
+                 << " --productores <procesos> <productores> <consumidores> [trabajo_por_ms] [mpmc|mutex]\n";
+            return 2;
+        }
+        long n = atol(argv[2]);
+        Proceso *procesos = new Proceso[n];
+        unsigned nombre = tablaNombres.internar("productor");
+        GeneradorCarga generador(1);
+        for (long i = 0; i < n; i++) {
+            procesos[i].id = (int)(i + 1);
+            procesos[i].nombre = nombre;
+            procesos[i].prioridad = 1;
+            procesos[i].estado = "Listo";
+            procesos[i].tiempoCPU = 1 + (int)(generador.uniforme() * 100);
+        }
+        long trabajo = argc > 5 ? atol(argv[5]) : 10;
+        ResultadoParalelo r;
+        if (tipo == "mpmc") {
+            ColaMPMC<Proceso *> listos(1024);
+            r = ejecutarConProductores(listos, procesos, n, atoi(argv[3]), atoi(argv[4]), trabajo);
+        } else {
+            ColaConMutex listos;
+            r = ejecutarConProductores(listos, procesos, n, atoi(argv[3]), atoi(argv[4]), trabajo);
+        }
+        cout << "\nCola de listos: " << tipo << "\n";
+        imprimirParalelo(r);
+        delete[] procesos;
+        return 0;
+    }
+#endif
+    if (argc > 1 && string(argv[1]) == "--round-robin") {
+        string modo = argc > 6 ? argv[6] : "adelantar";
+        if (argc < 5 || atol(argv[2]) < 0 || atoi(argv[3]) <= 0 || atof(argv[4]) <= 0
+            || (modo != "adelantar" && modo != "paso")) {
+            cerr << "Uso: " << argv[0]
+                 << " --round-robin <procesos> <quantum> <cpu_medio_ms> [semilla] [adelantar|paso]\n";
+            return 2;
+        }
+        int quantum = atoi(argv[3]);
+        unsigned long long semilla = argc > 5 ? strtoull(argv[5], NULL, 10) : 1;
+        imprimirRoundRobin(simularRoundRobin(atol(argv[2]), quantum, atof(argv[4]), semilla, modo == "adelantar"),
+                           quantum);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--simular") {
+        if (argc < 6 || atol(argv[2]) < 0 || atoi(argv[3]) <= 0 || atof(argv[4]) < 0 || atof(argv[5]) <= 0) {
+            cerr << "Uso: " << argv[0] << " --simular <procesos> <cpus> <llegada_media_ms> <cpu_medio_ms> [semilla]\n";
+            return 2;
+        }
+        int cpus = atoi(argv[3]);
+        unsigned long long semilla = argc > 6 ? strtoull(argv[6], NULL, 10) : 1;
+        imprimirSimulacion(simularCarga(atol(argv[2]), cpus, atof(argv[4]), atof(argv[5]), semilla), cpus);
+        return 0;
+    }
+
     Cola cola;
     Pila pila;
     Lista lista;
+    long long relojCPU = 0; // Reloj virtual de la CPU nica de la opcin 2 (ms)
+    int quantum = 0;        // 0 hasta configurarlo: cada proceso corre hasta terminar (FIFO)
     int op;
 
     do {
@@ -195,14 +971,25 @@ int main() {
         switch (op) {
             case 1: {
                 Proceso *p = new Proceso;  // usamos puntero dinmico
-                p->id = generarID();
                 cout << "\nIngrese nombre del proceso: ";
                 cin.ignore();
-                getline(cin, p->nombre);
+                string nombre;
+                getline(cin, nombre);
+                p->nombre = tablaNombres.internar(nombre);
                 cout << "Ingrese prioridad (1-10): ";
                 cin >> p->prioridad;
                 cout << "Ingrese tiempo de CPU estimado (ms): ";
-                cin >> p->tiempoCPU;
+                if (!(cin >> p->tiempoCPU) || p->tiempoCPU <= 0) {
+                    cin.clear();
+                    tablaNombres.soltar(p->nombre);
+                    delete p;
+                    cout << "\nTiempo de CPU invalido (debe ser mayor que 0).\n";
+                    pausa();
+                    break;
+                }
+                p->id = generarID();
+                p->restante = p->tiempoCPU;
+                p->llegada = relojCPU;
                 p->estado = "Listo";
 
                 lista.insertarFinal(p);
@@ -213,12 +1000,19 @@ int main() {
             }
 
             case 2: {
-                Proceso *p;
-                if (cola.desencolar(p)) {
-                    cout << "\nEjecutando proceso: " << p->nombre << "...\n";
-                    p->estado = "Finalizado";
-                    pila.push(p);
-                    cout << "Proceso finalizado y enviado a la pila de terminados.\n";
+                if (!cola.vacia()) {
+                    Proceso *p = cola.frente->data;
+                    cout << "\nEjecutando proceso: " << tablaNombres.texto(p->nombre) << "...\n";
+                    long long desde = relojCPU;
+                    // Sin quantum la CPU queda ocupada todo lo que le falta
+                    if (turnoRoundRobin(cola, pila, quantum > 0 ? quantum : p->restante, relojCPU)) {
+                        cout << "Inicio: " << p->inicio << " ms | Fin: " << p->fin << " ms\n";
+                        cout << "Proceso finalizado y enviado a la pila de terminados.\n";
+                    } else {
+                        cout << "Turno: " << desde << " - " << relojCPU << " ms | Restante: "
+                             << p->restante << " ms\n";
+                        cout << "Proceso devuelto al final de la cola.\n";
+                    }
                 } else {
                     cout << "\nNo hay procesos en la cola.\n";
                 }
@@ -227,17 +1021,119 @@ int main() {
             }
 
             case 3:
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
                 lista.mostrar();
-                pausa();
+                pausaSinLimpiar();
                 break;
 
             case 4:
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
                 cola.mostrar();
-                pausa();
+                pausaSinLimpiar();
                 break;
 
             case 5:
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
                 pila.mostrar();
+                pausaSinLimpiar();
+                break;
+
+            case 6:
+                cout << "\nNodos vivos: " << poolNodos.vivos
+                     << " | Pedidos: " << poolNodos.pedidos
+                     << " | Devueltos: " << poolNodos.devueltos
+                     << " | Slabs (mallocs): " << poolNodos.mallocs << "\n"
+                     << "Nombres distintos: " << tablaNombres.distintos
+                     << " | Bytes de la tabla de nombres: " << tablaNombres.bytesReservados() << "\n";
+                pausa();
+                break;
+
+            case 7: {
+                int cpus;
+                cout << "\nCantidad de CPU: ";
+                if (!(cin >> cpus) || cpus <= 0) {
+                    cin.clear();
+                    cout << "\nCantidad invalida.\n";
+                } else if (cola.vacia()) {
+                    cout << "\nNo hay procesos en la cola.\n";
+                } else {
+                    imprimirSimulacion(simularCola(cola, pila, cpus), cpus);
+                }
+                pausa();
+                break;
+            }
+
+            case 8: {
+                long n;
+                int cpus;
+                double llegada, cpuMedio;
+                cout << "\nCantidad de procesos: ";
+                cin >> n;
+                cout << "Cantidad de CPU: ";
+                cin >> cpus;
+                cout << "Tiempo medio entre llegadas (ms): ";
+                cin >> llegada;
+                cout << "Tiempo medio de CPU por proceso (ms): ";
+                cin >> cpuMedio;
+                if (cin.fail() || n < 0 || cpus <= 0 || llegada < 0 || cpuMedio <= 0) {
+                    cin.clear();
+                    cout << "\nDatos invalidos.\n";
+                } else {
+                    imprimirSimulacion(simularCarga(n, cpus, llegada, cpuMedio, 1), cpus);
+                }
+                pausa();
+                break;
+            }
+
+#ifdef CON_HILOS
+            case 9: {
+                int hilos;
+                cout << "\nCantidad de hilos: ";
+                if (!(cin >> hilos) || hilos <= 0) {
+                    cin.clear();
+                    cout << "\nCantidad invalida.\n";
+                } else if (cola.vacia()) {
+                    cout << "\nNo hay procesos en la cola.\n";
+                } else {
+                    vector<Proceso *> pendientes, terminados;
+                    Proceso *p;
+                    while (cola.desencolar(p)) pendientes.push_back(p);
+                    imprimirParalelo(ejecutarEnParalelo(&pendientes[0], (long)pendientes.size(), hilos,
+                                                        1000, true, terminados));
+                    for (size_t i = 0; i < terminados.size(); i++) {
+                        terminados[i]->restante = 0;
+                        pila.push(terminados[i]);
+                    }
+                }
+                pausa();
+                break;
+            }
+#endif
+
+            case 10: {
+                cout << "\nQuantum actual: ";
+                if (quantum > 0) cout << quantum << " ms";
+                else cout << "ninguno (cada proceso corre hasta terminar)";
+                cout << "\nNuevo quantum en ms (mayor que 0): ";
+                int nuevo;
+                if (!(cin >> nuevo) || nuevo <= 0) {
+                    cin.clear();
+                    cout << "\nQuantum invalido, no se cambia.\n";
+                } else {
+                    quantum = nuevo;
+                }
+                pausa();
+                break;
+            }
+
+            case 11:
+                if (quantum <= 0) {
+                    cout << "\nPrimero configure un quantum (opcion 10).\n";
+                } else if (cola.vacia()) {
+                    cout << "\nNo hay procesos en la cola.\n";
+                } else {
+                    imprimirRoundRobin(ejecutarRoundRobin(cola, pila, quantum, relojCPU, true), quantum);
+                }
                 pausa();
                 break;
 
@@ -253,4 +1149,4 @@ int main() {
 
     return 0;
 }
-
+#endif
@@ -0,0 +1,191 @@
+#ifndef TABLA_CONCURRENTE_H
+#define TABLA_CONCURRENTE_H
+
+#include <cstddef> // NULL
+#include "tabla_pid.h"
+#include "pool_nodos.h"
+
+#ifdef CON_HILOS
+#include <pthread.h>
+#endif
+
+// Cerrojo de lectores y escritor, y cerrojo simple. Con CON_HILOS son los
+// de pthreads; sin hilos no hacen nada y el compilador los borra, as el
+// gestor de un solo hilo no paga por ellos.
+#ifdef CON_HILOS
+struct CerrojoLectores {
+    pthread_rwlock_t cerrojo;
+
+    CerrojoLectores() {
+        pthread_rwlockattr_t atributos;
+        pthread_rwlockattr_init(&atributos);
+#ifdef __GLIBC__
+        // glibc prefiere a los lectores: con bsquedas continuas un
+        // escritor podra no entrar nunca
+        pthread_rwlockattr_setkind_np(&atributos, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+        pthread_rwlock_init(&cerrojo, &atributos);
+        pthread_rwlockattr_destroy(&atributos);
+    }
+
+    ~CerrojoLectores() {
+        pthread_rwlock_destroy(&cerrojo);
+    }
+
+    void leer() { pthread_rwlock_rdlock(&cerrojo); }
+    void escribir() { pthread_rwlock_wrlock(&cerrojo); }
+    void soltar() { pthread_rwlock_unlock(&cerrojo); }
+};
+
+struct Cerrojo {
+    pthread_mutex_t cerrojo;
+
+    Cerrojo() {
+        pthread_mutex_init(&cerrojo, NULL);
+    }
+
+    ~Cerrojo() {
+        pthread_mutex_destroy(&cerrojo);
+    }
+
+    void tomar() { pthread_mutex_lock(&cerrojo); }
+    void soltar() { pthread_mutex_unlock(&cerrojo); }
+};
+#else
+struct CerrojoLectores {
+    void leer() {}
+    void escribir() {}
+    void soltar() {}
+};
+
+struct Cerrojo {
+    void tomar() {}
+    void soltar() {}
+};
+#endif
+
+// Registro PID -> T partido en FRAGMENTOS fragmentos segn el hash del PID.
+// Cada fragmento tiene su ndice PID -> T*, su propio pool (es el dueo de
+// sus T: los crea y los devuelve) y un cerrojo de lectores y escritor. Los
+// hilos que buscan en un fragmento no se bloquean entre s y los que dan de
+// alta o de baja solo bloquean ese fragmento. Con FRAGMENTOS = 1 queda una
+// tabla con un nico cerrojo global.
+//
+// buscar() toma el cerrojo del fragmento por su cuenta. Una alta o baja de
+// varios pasos toma el fragmento con escribir(pid), usa buscarTomado(),
+// alta() y baja(), y lo suelta con soltar(pid). Los T* que devuelve siguen
+// vlidos hasta que alguien d de baja ese PID.
+template <typename T, int FRAGMENTOS>
+struct RegistroConcurrente {
+    struct Fragmento {
+        CerrojoLectores cerrojo;
+        TablaPID<T*> indice;
+        PoolNodos<T> pool;
+        char relleno[64]; // Que el cerrojo del siguiente no comparta lnea de cach
+    };
+
+    Fragmento fragmentos[FRAGMENTOS];
+
+    // Otro hash que el de TablaPID: si se usaran los mismos bits, todos los
+    // PID de un fragmento caeran en la misma zona de su ndice
+    static unsigned fragmentoDe(int pid) {
+        unsigned h = (unsigned)pid * 0x85EBCA6Bu;
+        h ^= h >> 16;
+        return h % FRAGMENTOS;
+    }
+
+    Fragmento& de(int pid) {
+        return fragmentos[fragmentoDe(pid)];
+    }
+
+    T* buscar(int pid) {
+        Fragmento& f = de(pid);
+        f.cerrojo.leer();
+        T* p = f.indice.buscar(pid);
+        f.cerrojo.soltar();
+        return p;
+    }
+
+    // Igual que buscar(), contando las casillas revisadas (para las mtricas)
+    T* buscar(int pid, unsigned& sondeos) {
+        Fragmento& f = de(pid);
+        f.cerrojo.leer();
+        T* p = f.indice.buscar(pid, sondeos);
+        f.cerrojo.soltar();
+        return p;
+    }
+
+    void escribir(int pid) { de(pid).cerrojo.escribir(); }
+    void soltar(int pid) { de(pid).cerrojo.soltar(); }
+
+    // Las tres siguientes no toman cerrojos: el llamador ya tiene el
+    // fragmento de 'pid' (o es el nico hilo, como al cargar un archivo)
+    T* buscarTomado(int pid) {
+        return de(pid).indice.buscar(pid);
+    }
+
+    // Un T nuevo (T()) ya registrado con 'pid'. NULL si el PID ya estaba.
+    T* alta(int pid) {
+        Fragmento& f = de(pid);
+        T* p = f.pool.obtener();
+        if (!f.indice.insertarNuevo(pid, p)) {
+            f.pool.devolver(p);
+            return NULL;
+        }
+        return p;
+    }
+
+    // Saca 'p' (registrado con 'pid') del ndice y lo devuelve al pool
+    void baja(int pid, T* p) {
+        Fragmento& f = de(pid);
+        f.indice.eliminar(pid);
+        f.pool.devolver(p);
+    }
+
+    // Para cargas masivas de un solo hilo
+    void reservar(unsigned n) {
+        for (int i = 0; i < FRAGMENTOS; i++) fragmentos[i].indice.reservar(n / FRAGMENTOS);
+    }
+
+    void precargar(int pid) {
+        de(pid).indice.precargar(pid);
+    }
+
+    // Suma de los fragmentos (cada uno ledo bajo su cerrojo)
+    long cantidad() {
+        long total = 0;
+        for (int i = 0; i < FRAGMENTOS; i++) {
+            fragmentos[i].cerrojo.leer();
+            total += fragmentos[i].indice.cantidad;
+            fragmentos[i].cerrojo.soltar();
+        }
+        return total;
+    }
+
+    // Casillas de todos los ndices (para estimar la memoria usada)
+    unsigned long long capacidad() const {
+        unsigned long long total = 0;
+        for (int i = 0; i < FRAGMENTOS; i++) total += fragmentos[i].indice.capacidad;
+        return total;
+    }
+
+    // Contadores de los pools de todos los fragmentos, sumados
+    void contadores(long& vivos, unsigned long long& pedidos, unsigned long long& devueltos,
+                    unsigned long long& mallocs) const {
+        vivos = 0;
+        pedidos = devueltos = mallocs = 0;
+        for (int i = 0; i < FRAGMENTOS; i++) {
+            vivos += fragmentos[i].pool.vivos;
+            pedidos += fragmentos[i].pool.pedidos;
+            devueltos += fragmentos[i].pool.devueltos;
+            mallocs += fragmentos[i].pool.mallocs;
+        }
+    }
+
+    // Suelta los pools de todos los fragmentos (al salir)
+    void liberarTodo() {
+        for (int i = 0; i < FRAGMENTOS; i++) fragmentos[i].pool.liberarTodo();
+    }
+};
+
+#endif
@@ -0,0 +1,228 @@
+#ifndef TABLA_NOMBRES_H
+#define TABLA_NOMBRES_H
+
+#include <cstring> // memcpy, memcmp
+#include <string>
+
+// Tabla de nombres internados.
+// Cada nombre distinto se guarda una sola vez en una arena de caracteres y
+// los procesos solo llevan su id de 32 bits. Con millones de procesos que
+// comparten unos pocos cientos de nombres ("worker", "gc", ...) esto evita
+// un std::string (y su memoria en el heap) por proceso.
+//
+// Los ids llevan un contador de referencias: cuando el ltimo proceso que
+// usa un nombre se borra, el id se recicla y su texto queda como basura en
+// la arena hasta la prxima compactacin. El id 0 no se usa nunca.
+struct TablaNombres {
+    // Datos por id
+    unsigned* inicio;  // Desplazamiento en la arena (en los ids libres: siguiente libre)
+    unsigned* largo;
+    unsigned* refs;
+    unsigned* hashes;  // Hash del texto, para no recalcularlo al reubicar
+    unsigned proximoId;
+    unsigned capacidadIds;
+    unsigned idLibre;
+    unsigned distintos; // Ids en uso
+
+    // Arena con el texto de todos los nombres (cada uno termina en '\0')
+    char* arena;
+    unsigned arenaUsada;
+    unsigned arenaCapacidad;
+    unsigned arenaBasura;
+
+    // Hash texto -> id con sondeo lineal (0 = casilla vaca)
+    unsigned* casillas;
+    unsigned capacidadHash; // Potencia de 2
+    int bits;
+
+    TablaNombres() {
+        capacidadIds = 16;
+        proximoId = 1;
+        idLibre = 0;
+        distintos = 0;
+        inicio = new unsigned[capacidadIds];
+        largo = new unsigned[capacidadIds];
+        refs = new unsigned[capacidadIds];
+        hashes = new unsigned[capacidadIds];
+
+        arenaCapacidad = 1024;
+        arenaUsada = 0;
+        arenaBasura = 0;
+        arena = new char[arenaCapacidad];
+
+        bits = 5;
+        capacidadHash = 1u << bits;
+        casillas = new unsigned[capacidadHash]();
+    }
+
+    ~TablaNombres() {
+        delete[] inicio;
+        delete[] largo;
+        delete[] refs;
+        delete[] hashes;
+        delete[] arena;
+        delete[] casillas;
+    }
+
+    // FNV-1a de 32 bits
+    static unsigned hashTexto(const char* s, unsigned n) {
+        unsigned h = 2166136261u;
+        for (unsigned i = 0; i < n; i++) {
+            h ^= (unsigned char)s[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    unsigned casilla(unsigned h) const {
+        return (h * 2654435769u) >> (32 - bits);
+    }
+
+    const char* texto(unsigned id) const {
+        return arena + inicio[id];
+    }
+
+    unsigned largoDe(unsigned id) const {
+        return largo[id];
+    }
+
+    // Devuelve el id del nombre (crendolo si hace falta) y suma una referencia
+    unsigned internar(const char* s, unsigned n) {
+        unsigned h = hashTexto(s, n);
+        unsigned mascara = capacidadHash - 1;
+        unsigned i = casilla(h);
+        for (; casillas[i] != 0; i = (i + 1) & mascara) {
+            unsigned id = casillas[i];
+            if (hashes[id] == h && largo[id] == n && memcmp(arena + inicio[id], s, n) == 0) {
+                refs[id]++;
+                return id;
+            }
+        }
+
+        unsigned id = nuevoId();
+        hashes[id] = h;
+        largo[id] = n;
+        refs[id] = 1;
+        inicio[id] = guardarTexto(s, n);
+        distintos++;
+        if (distintos * 4 > capacidadHash * 3) crecerHash(); // Factor de carga <= 0.75
+        else casillas[i] = id;
+        return id;
+    }
+
+    unsigned internar(const std::string& s) {
+        return internar(s.data(), (unsigned)s.size());
+    }
+
+    // Suma una referencia a un id que ya existe (por ejemplo, al copiar)
+    void retener(unsigned id) {
+        refs[id]++;
+    }
+
+    // Quita una referencia; si era la ltima, el nombre se borra
+    void soltar(unsigned id) {
+        if (--refs[id] > 0) return;
+
+        // Sacar el id del hash con desplazamiento hacia atrs (sin lpidas)
+        unsigned mascara = capacidadHash - 1;
+        unsigned i = casilla(hashes[id]);
+        while (casillas[i] != id) i = (i + 1) & mascara;
+        unsigned hueco = i;
+        for (unsigned j = (i + 1) & mascara; casillas[j] != 0; j = (j + 1) & mascara) {
+            unsigned ideal = casilla(hashes[casillas[j]]);
+            if (((j - ideal) & mascara) >= ((j - hueco) & mascara)) {
+                casillas[hueco] = casillas[j];
+                hueco = j;
+            }
+        }
+        casillas[hueco] = 0;
+
+        arenaBasura += largo[id] + 1;
+        inicio[id] = idLibre;
+        idLibre = id;
+        distintos--;
+        if (arenaBasura > 4096 && arenaBasura * 2 > arenaUsada) compactarArena();
+    }
+
+    unsigned nuevoId() {
+        if (idLibre != 0) {
+            unsigned id = idLibre;
+            idLibre = inicio[id];
+            return id;
+        }
+        if (proximoId == capacidadIds) {
+            unsigned nueva = capacidadIds * 2;
+            agrandar(inicio, proximoId, nueva);
+            agrandar(largo, proximoId, nueva);
+            agrandar(refs, proximoId, nueva);
+            agrandar(hashes, proximoId, nueva);
+            capacidadIds = nueva;
+        }
+        return proximoId++;
+    }
+
+    template <typename T>
+    static void agrandar(T*& arreglo, unsigned usados, unsigned capacidadNueva) {
+        T* nuevo = new T[capacidadNueva];
+        memcpy(nuevo, arreglo, usados * sizeof(T));
+        delete[] arreglo;
+        arreglo = nuevo;
+    }
+
+    unsigned guardarTexto(const char* s, unsigned n) {
+        if (arenaUsada + n + 1 > arenaCapacidad) {
+            unsigned nueva = arenaCapacidad * 2;
+            while (arenaUsada + n + 1 > nueva) nueva *= 2;
+            agrandar(arena, arenaUsada, nueva);
+            arenaCapacidad = nueva;
+        }
+        unsigned pos = arenaUsada;
+        memcpy(arena + pos, s, n);
+        arena[pos + n] = '\0';
+        arenaUsada += n + 1;
+        return pos;
+    }
+
+    void crecerHash() {
+        delete[] casillas;
+        bits++;
+        capacidadHash = 1u << bits;
+        casillas = new unsigned[capacidadHash]();
+        unsigned mascara = capacidadHash - 1;
+        for (unsigned id = 1; id < proximoId; id++) {
+            if (refs[id] == 0) continue; // Id libre
+            unsigned i = casilla(hashes[id]);
+            while (casillas[i] != 0) i = (i + 1) & mascara;
+            casillas[i] = id;
+        }
+    }
+
+    // Reescribe la arena solo con los nombres en uso (los ids no cambian)
+    void compactarArena() {
+        unsigned vivos = arenaUsada - arenaBasura;
+        unsigned nuevaCapacidad = 1024;
+        while (nuevaCapacidad < vivos * 2) nuevaCapacidad *= 2;
+        char* nueva = new char[nuevaCapacidad];
+        unsigned usada = 0;
+        for (unsigned id = 1; id < proximoId; id++) {
+            if (refs[id] == 0) continue;
+            memcpy(nueva + usada, arena + inicio[id], largo[id] + 1);
+            inicio[id] = usada;
+            usada += largo[id] + 1;
+        }
+        delete[] arena;
+        arena = nueva;
+        arenaCapacidad = nuevaCapacidad;
+        arenaUsada = usada;
+        arenaBasura = 0;
+    }
+
+    // Memoria reservada por la tabla (arena + arreglos por id + hash)
+    unsigned long long bytesReservados() const {
+        return (unsigned long long)arenaCapacidad
+             + (unsigned long long)capacidadIds * 4 * sizeof(unsigned)
+             + (unsigned long long)capacidadHash * sizeof(unsigned);
+    }
+};
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef TABLA_PID_H
+#define TABLA_PID_H
+
+#include <cstddef> // NULL
+
+// ndice hash PID -> V (direccionamiento abierto con sondeo lineal).
+// Las entradas viven en un solo arreglo contiguo, as que una bsqueda
+// normalmente toca una o dos lneas de cach. Como los PID vlidos son
+// siempre > 0, pid == 0 marca una casilla vaca. buscar() devuelve V()
+// (NULL o 0) cuando el PID no est.
+template <typename V>
+struct TablaPID {
+    struct Entrada {
+        int pid;
+        V valor;
+    };
+
+    Entrada* entradas;
+    unsigned capacidad; // Siempre potencia de 2
+    unsigned cantidad;
+    int bits;           // log2(capacidad), usado por la funcin hash
+
+    TablaPID() {
+        bits = 4;
+        capacidad = 1u << bits;
+        cantidad = 0;
+        entradas = new Entrada[capacidad]();
+    }
+
+    ~TablaPID() {
+        delete[] entradas;
+    }
+
+    // Hash multiplicativo (Fibonacci): reparte bien PIDs consecutivos
+    unsigned casilla(int pid) const {
+        return ((unsigned)pid * 2654435769u) >> (32 - bits);
+    }
+
+    V buscar(int pid) const {
+        unsigned mascara = capacidad - 1;
+        for (unsigned i = casilla(pid); entradas[i].pid != 0; i = (i + 1) & mascara) {
+            if (entradas[i].pid == pid) return entradas[i].valor;
+        }
+        return V();
+    }
+
+    // Igual que buscar(), contando las casillas revisadas (para las mtricas)
+    V buscar(int pid, unsigned& sondeos) const {
+        unsigned mascara = capacidad - 1;
+        sondeos = 1;
+        for (unsigned i = casilla(pid); entradas[i].pid != 0; i = (i + 1) & mascara, sondeos++) {
+            if (entradas[i].pid == pid) return entradas[i].valor;
+        }
+        return V();
+    }
+
+    // Trae a la cach la casilla de 'pid' antes de usarla. En recorridos
+    // largos (cargar una instantnea) se pide unas casillas por adelantado
+    // y la espera a memoria de una bsqueda se superpone con las anteriores.
+    void precargar(int pid) const {
+#ifdef __GNUC__
+        __builtin_prefetch(&entradas[casilla(pid)]);
+#else
+        (void)pid;
+#endif
+    }
+
+    // Inserta si el PID no estaba, con un solo sondeo. false si ya estaba.
+    bool insertarNuevo(int pid, V valor) {
+        if ((cantidad + 1) * 4 > capacidad * 3) crecer();
+        unsigned mascara = capacidad - 1;
+        unsigned i = casilla(pid);
+        for (; entradas[i].pid != 0; i = (i + 1) & mascara) {
+            if (entradas[i].pid == pid) return false;
+        }
+        entradas[i].pid = pid;
+        entradas[i].valor = valor;
+        cantidad++;
+        return true;
+    }
+
+    // Inserta sin revisar duplicados (el llamador ya verific con buscar)
+    void insertar(int pid, V valor) {
+        if ((cantidad + 1) * 4 > capacidad * 3) crecer(); // Factor de carga <= 0.75
+        colocar(pid, valor);
+        cantidad++;
+    }
+
+    // Agranda la tabla de una vez para 'n' entradas (til antes de una carga
+    // masiva: evita rehacer la tabla en cada duplicacin)
+    void reservar(unsigned n) {
+        while ((unsigned long long)n * 4 > (unsigned long long)capacidad * 3) crecer();
+    }
+
+    // Borrado por desplazamiento hacia atrs: no deja lpidas, as que las
+    // bsquedas no se degradan aunque haya muchas altas y bajas.
+    void eliminar(int pid) {
+        unsigned mascara = capacidad - 1;
+        unsigned i = casilla(pid);
+        while (entradas[i].pid != pid) {
+            if (entradas[i].pid == 0) return; // No estaba
+            i = (i + 1) & mascara;
+        }
+        unsigned hueco = i;
+        for (unsigned j = (i + 1) & mascara; entradas[j].pid != 0; j = (j + 1) & mascara) {
+            unsigned ideal = casilla(entradas[j].pid);
+            // Mover j al hueco solo si su casilla ideal no queda entre el hueco y j
+            if (((j - ideal) & mascara) >= ((j - hueco) & mascara)) {
+                entradas[hueco] = entradas[j];
+                hueco = j;
+            }
+        }
+        entradas[hueco].pid = 0;
+        entradas[hueco].valor = V();
+        cantidad--;
+    }
+
+    void colocar(int pid, V valor) {
+        unsigned mascara = capacidad - 1;
+        unsigned i = casilla(pid);
+        while (entradas[i].pid != 0) i = (i + 1) & mascara;
+        entradas[i].pid = pid;
+        entradas[i].valor = valor;
+    }
+
+    void crecer() {
+        Entrada* viejas = entradas;
+        unsigned capacidadVieja = capacidad;
+        bits++;
+        capacidad = 1u << bits;
+        entradas = new Entrada[capacidad]();
+        for (unsigned i = 0; i < capacidadVieja; i++) {
+            if (viejas[i].pid != 0) colocar(viejas[i].pid, viejas[i].valor);
+        }
+        delete[] viejas;
+    }
+};
+
+#endif
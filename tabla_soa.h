@@ -0,0 +1,479 @@
+#ifndef TABLA_SOA_H
+#define TABLA_SOA_H
+
+#include <cstring> // memcpy
+#include "tabla_pid.h"
+#include "tabla_nombres.h"
+
+// Motor alternativo de almacenamiento: tabla de procesos en columnas
+// (structure of arrays). En vez de un nodo por proceso, cada campo vive en
+// su propio arreglo contiguo (pids, prioridades, estados) y los nombres se
+// guardan aparte, internados en una TablaNombres (la columna solo lleva el
+// id). Un recorrido completo lee solo las columnas que necesita, de corrido,
+// sin seguir punteros.
+//
+// Las columnas se mantienen densas (sin huecos): al borrar, el ltimo
+// proceso ocupa el lugar del borrado. Por eso la cola y la pila no guardan
+// posiciones sino manejadores estables (ranura + generacin), que siguen
+// siendo vlidos aunque el proceso se mueva dentro de las columnas, y se
+// verifican con valido() antes de leer el proceso al desencolar o liberar:
+// una ranura liberada y reusada no se confunde con el proceso nuevo.
+
+enum EstadoProceso {
+    ESTADO_LISTO = 0,     // Creado, fuera de la cola
+    ESTADO_EN_COLA = 1,   // Esperando en la cola de CPU
+    ESTADO_EJECUTADO = 2  // Ya pas por la CPU
+};
+
+// Manejador estable de un proceso. La generacin cambia cada vez que la
+// ranura se libera, as que un manejador viejo se detecta como invlido.
+struct ManejadorProceso {
+    unsigned ranura;
+    unsigned generacion;
+};
+
+// Agranda un arreglo dinmico conservando sus 'usados' primeros elementos
+template <typename T>
+void crecerArreglo(T*& arreglo, unsigned usados, unsigned capacidadNueva) {
+    T* nuevo = new T[capacidadNueva];
+    if (usados > 0) memcpy(nuevo, arreglo, usados * sizeof(T));
+    delete[] arreglo;
+    arreglo = nuevo;
+}
+
+// Resultado de un recorrido completo de la tabla
+struct ResumenProcesos {
+    long total;
+    long enCola;
+    long ejecutados;
+    long long sumaPrioridad;
+    int minPrioridad;
+    int maxPrioridad;
+};
+
+struct TablaProcesosSoA {
+    // Columnas densas: posicin 0..cantidad-1
+    unsigned cantidad;
+    unsigned capacidad;
+    int* pids;
+    int* prioridades;
+    unsigned char* estados;
+    unsigned* nombres;      // Id del nombre en 'tablaNombres'
+    unsigned* ranuraDe;     // Posicin densa -> ranura
+
+    // Datos por ranura (estables mientras el proceso exista). La ranura 0 no
+    // se usa, as el ndice por PID puede devolver 0 como "no encontrado".
+    unsigned capacidadRanuras;
+    unsigned proximaRanura; // Primera ranura nunca usada
+    unsigned ranuraLibre;   // Lista de ranuras liberadas (enlazada por densoDe)
+    unsigned* densoDe;      // Ranura -> posicin densa
+    unsigned* generaciones;
+    int* posCola;           // Posicin en ColaSoA (-1 si no est encolado)
+    int* primerBloque;      // Primer bloque de PilaBloquesSoA del proceso (-1 si no tiene)
+    int* bloquesMemoria;
+
+    TablaNombres* tablaNombres; // Dnde viven los textos de los nombres
+    TablaPID<unsigned> indice; // PID -> ranura
+
+    TablaProcesosSoA() {
+        cantidad = 0;
+        capacidad = 16;
+        pids = new int[capacidad];
+        prioridades = new int[capacidad];
+        estados = new unsigned char[capacidad];
+        nombres = new unsigned[capacidad];
+        ranuraDe = new unsigned[capacidad];
+
+        capacidadRanuras = 16;
+        proximaRanura = 1;
+        ranuraLibre = 0;
+        densoDe = new unsigned[capacidadRanuras];
+        generaciones = new unsigned[capacidadRanuras]();
+        posCola = new int[capacidadRanuras];
+        primerBloque = new int[capacidadRanuras];
+        bloquesMemoria = new int[capacidadRanuras];
+
+        tablaNombres = NULL;
+    }
+
+    ~TablaProcesosSoA() {
+        delete[] pids;
+        delete[] prioridades;
+        delete[] estados;
+        delete[] nombres;
+        delete[] ranuraDe;
+        delete[] densoDe;
+        delete[] generaciones;
+        delete[] posCola;
+        delete[] primerBloque;
+        delete[] bloquesMemoria;
+    }
+
+    // Ranura del proceso con ese PID, o 0 si no existe
+    unsigned ranuraDePID(int pid) const {
+        return indice.buscar(pid);
+    }
+
+    ManejadorProceso manejador(unsigned ranura) const {
+        ManejadorProceso h;
+        h.ranura = ranura;
+        h.generacion = generaciones[ranura];
+        return h;
+    }
+
+    bool valido(ManejadorProceso h) const {
+        return h.ranura > 0 && h.ranura < proximaRanura && generaciones[h.ranura] == h.generacion;
+    }
+
+    // Acceso a las columnas a partir de una ranura
+    int pidDe(unsigned ranura) const { return pids[densoDe[ranura]]; }
+    int prioridadDe(unsigned ranura) const { return prioridades[densoDe[ranura]]; }
+    unsigned char estadoDe(unsigned ranura) const { return estados[densoDe[ranura]]; }
+    void fijarEstado(unsigned ranura, EstadoProceso e) { estados[densoDe[ranura]] = (unsigned char)e; }
+    void fijarPrioridad(unsigned ranura, int prioridad) { prioridades[densoDe[ranura]] = prioridad; }
+    const char* nombreDe(unsigned ranura) const { return tablaNombres->texto(nombres[densoDe[ranura]]); }
+    unsigned largoNombreDe(unsigned ranura) const { return tablaNombres->largoDe(nombres[densoDe[ranura]]); }
+
+    // Crea un proceso (el llamador ya verific que el PID no exista)
+    ManejadorProceso crear(int pid, const char* nombre, unsigned largo, int prioridad) {
+        if (cantidad == capacidad) {
+            unsigned nueva = capacidad * 2;
+            crecerArreglo(pids, cantidad, nueva);
+            crecerArreglo(prioridades, cantidad, nueva);
+            crecerArreglo(estados, cantidad, nueva);
+            crecerArreglo(nombres, cantidad, nueva);
+            crecerArreglo(ranuraDe, cantidad, nueva);
+            capacidad = nueva;
+        }
+
+        unsigned ranura;
+        if (ranuraLibre != 0) {
+            ranura = ranuraLibre;
+            ranuraLibre = densoDe[ranura];
+        } else {
+            if (proximaRanura == capacidadRanuras) {
+                unsigned nueva = capacidadRanuras * 2;
+                crecerArreglo(densoDe, proximaRanura, nueva);
+                crecerArreglo(generaciones, proximaRanura, nueva);
+                crecerArreglo(posCola, proximaRanura, nueva);
+                crecerArreglo(primerBloque, proximaRanura, nueva);
+                crecerArreglo(bloquesMemoria, proximaRanura, nueva);
+                for (unsigned r = proximaRanura; r < nueva; r++) generaciones[r] = 0;
+                capacidadRanuras = nueva;
+            }
+            ranura = proximaRanura++;
+        }
+
+        unsigned d = cantidad++;
+        pids[d] = pid;
+        prioridades[d] = prioridad;
+        estados[d] = ESTADO_LISTO;
+        nombres[d] = tablaNombres->internar(nombre, largo);
+        ranuraDe[d] = ranura;
+
+        densoDe[ranura] = d;
+        posCola[ranura] = -1;
+        primerBloque[ranura] = -1;
+        bloquesMemoria[ranura] = 0;
+        indice.insertar(pid, ranura);
+        return manejador(ranura);
+    }
+
+    // Borra el proceso de la ranura. El llamador debe haberlo sacado antes
+    // de la cola y de la pila de memoria.
+    void borrar(unsigned ranura) {
+        unsigned d = densoDe[ranura];
+        indice.eliminar(pids[d]);
+        tablaNombres->soltar(nombres[d]);
+
+        // El ltimo proceso ocupa el hueco para que las columnas sigan densas
+        unsigned ultimo = cantidad - 1;
+        if (d != ultimo) {
+            pids[d] = pids[ultimo];
+            prioridades[d] = prioridades[ultimo];
+            estados[d] = estados[ultimo];
+            nombres[d] = nombres[ultimo];
+            ranuraDe[d] = ranuraDe[ultimo];
+            densoDe[ranuraDe[d]] = d;
+        }
+        cantidad--;
+
+        generaciones[ranura]++; // Invalida los manejadores viejos
+        densoDe[ranura] = ranuraLibre;
+        ranuraLibre = ranura;
+    }
+
+    // Memoria reservada por las columnas, las ranuras y el ndice (sin los
+    // textos de los nombres, que viven en tablaNombres)
+    unsigned long long bytesReservados() const {
+        return (unsigned long long)capacidad * (2 * sizeof(int) + sizeof(unsigned char) + 2 * sizeof(unsigned))
+             + (unsigned long long)capacidadRanuras * (2 * sizeof(unsigned) + 3 * sizeof(int))
+             + (unsigned long long)indice.capacidad * sizeof(TablaPID<unsigned>::Entrada);
+    }
+
+    // Recorrido completo: solo lee las columnas de prioridad y estado
+    ResumenProcesos resumen() const {
+        ResumenProcesos r;
+        r.total = cantidad;
+        r.enCola = 0;
+        r.ejecutados = 0;
+        r.sumaPrioridad = 0;
+        r.minPrioridad = 0;
+        r.maxPrioridad = 0;
+        if (cantidad == 0) return r;
+
+        int minimo = prioridades[0], maximo = prioridades[0];
+        long long suma = 0;
+        for (unsigned d = 0; d < cantidad; d++) {
+            int p = prioridades[d];
+            suma += p;
+            if (p < minimo) minimo = p;
+            if (p > maximo) maximo = p;
+        }
+        long enCola = 0, ejecutados = 0;
+        for (unsigned d = 0; d < cantidad; d++) {
+            enCola += estados[d] == ESTADO_EN_COLA;
+            ejecutados += estados[d] == ESTADO_EJECUTADO;
+        }
+        r.enCola = enCola;
+        r.ejecutados = ejecutados;
+        r.sumaPrioridad = suma;
+        r.minPrioridad = minimo;
+        r.maxPrioridad = maximo;
+        return r;
+    }
+};
+
+// Cola de CPU del motor SoA: el mismo montculo (prioridad, orden de
+// llegada) que ColaPrioridad, pero los nodos guardan manejadores en lugar de
+// punteros y la posicin de cada proceso vive en la columna posCola.
+struct NodoColaSoA {
+    ManejadorProceso proceso;
+    int prioridad;
+    unsigned long long orden;
+};
+
+struct ColaSoA {
+    TablaProcesosSoA* tabla;
+    NodoColaSoA* nodos;
+    int cantidad;
+    int capacidad;
+    unsigned long long llegadas;
+
+    ColaSoA() {
+        tabla = NULL;
+        capacidad = 16;
+        cantidad = 0;
+        llegadas = 0;
+        nodos = new NodoColaSoA[capacidad];
+    }
+
+    ~ColaSoA() {
+        delete[] nodos;
+    }
+
+    static bool antes(const NodoColaSoA& a, const NodoColaSoA& b) {
+        if (a.prioridad != b.prioridad) return a.prioridad < b.prioridad;
+        return a.orden < b.orden;
+    }
+
+    void colocar(int i, const NodoColaSoA& n) {
+        nodos[i] = n;
+        // Un manejador vencido no escribe: la ranura puede ser de otro proceso
+        if (tabla->valido(n.proceso)) tabla->posCola[n.proceso.ranura] = i;
+    }
+
+    void subir(int i) {
+        NodoColaSoA n = nodos[i];
+        while (i > 0) {
+            int padre = (i - 1) / 2;
+            if (!antes(n, nodos[padre])) break;
+            colocar(i, nodos[padre]);
+            i = padre;
+        }
+        colocar(i, n);
+    }
+
+    void bajar(int i) {
+        NodoColaSoA n = nodos[i];
+        while (true) {
+            int hijo = 2 * i + 1;
+            if (hijo >= cantidad) break;
+            if (hijo + 1 < cantidad && antes(nodos[hijo + 1], nodos[hijo])) hijo++;
+            if (!antes(nodos[hijo], n)) break;
+            colocar(i, nodos[hijo]);
+            i = hijo;
+        }
+        colocar(i, n);
+    }
+
+    void insertar(ManejadorProceso h) {
+        if (cantidad == capacidad) {
+            crecerArreglo(nodos, cantidad, capacidad * 2);
+            capacidad *= 2;
+        }
+        NodoColaSoA n;
+        n.proceso = h;
+        n.prioridad = tabla->prioridadDe(h.ranura);
+        n.orden = llegadas++;
+        colocar(cantidad, n);
+        cantidad++;
+        subir(cantidad - 1);
+    }
+
+    void reubicar(int i) {
+        if (i > 0 && antes(nodos[i], nodos[(i - 1) / 2])) subir(i);
+        else bajar(i);
+    }
+
+    // Un manejador vencido no toca la columna: la ranura ya es de otro
+    ManejadorProceso quitarEn(int i) {
+        ManejadorProceso h = nodos[i].proceso;
+        if (tabla->valido(h)) tabla->posCola[h.ranura] = -1;
+        cantidad--;
+        if (i != cantidad) {
+            colocar(i, nodos[cantidad]);
+            reubicar(i);
+        }
+        return h;
+    }
+
+    // Igual que ColaPrioridad::cambiarPrioridad: O(log n), conserva la llegada
+    void cambiarPrioridad(int i, int prioridad) {
+        nodos[i].prioridad = prioridad;
+        reubicar(i);
+    }
+
+    // Manejador del proceso de mayor prioridad (ranura 0 si la cola est
+    // vaca). El llamador lo verifica con valido() antes de usarlo.
+    ManejadorProceso extraer() {
+        if (cantidad == 0) {
+            ManejadorProceso vacio = { 0, 0 };
+            return vacio;
+        }
+        return quitarEn(0);
+    }
+};
+
+// Pila de memoria del motor SoA. Los bloques viven en un arreglo y se
+// enlazan por ndice, igual que BloqueMemoria: una lista para el orden LIFO
+// y otra por proceso (que arranca en la columna primerBloque).
+struct BloqueSoA {
+    ManejadorProceso proceso;
+    int tamanio;
+    int siguiente;     // Hacia la base (-1 = ninguno); en los libres, el siguiente libre
+    int anterior;      // Hacia el tope
+    int sigDelProceso;
+    int antDelProceso;
+};
+
+struct PilaBloquesSoA {
+    TablaProcesosSoA* tabla;
+    BloqueSoA* bloques;
+    int capacidad;
+    int usados;  // Casillas usadas alguna vez
+    int libre;   // Lista de casillas libres
+    int tope;
+    int cantidad;
+
+    PilaBloquesSoA() {
+        tabla = NULL;
+        capacidad = 16;
+        usados = 0;
+        libre = -1;
+        tope = -1;
+        cantidad = 0;
+        bloques = new BloqueSoA[capacidad];
+    }
+
+    ~PilaBloquesSoA() {
+        delete[] bloques;
+    }
+
+    int apilar(ManejadorProceso h, int tamanio) {
+        unsigned ranura = h.ranura;
+        int b;
+        if (libre != -1) {
+            b = libre;
+            libre = bloques[b].siguiente;
+        } else {
+            if (usados == capacidad) {
+                crecerArreglo(bloques, usados, capacidad * 2);
+                capacidad *= 2;
+            }
+            b = usados++;
+        }
+        BloqueSoA& n = bloques[b];
+        n.proceso = h;
+        n.tamanio = tamanio;
+        n.anterior = -1;
+        n.siguiente = tope;
+        if (tope != -1) bloques[tope].anterior = b;
+        tope = b;
+
+        n.antDelProceso = -1;
+        n.sigDelProceso = tabla->primerBloque[ranura];
+        if (n.sigDelProceso != -1) bloques[n.sigDelProceso].antDelProceso = b;
+        tabla->primerBloque[ranura] = b;
+        tabla->bloquesMemoria[ranura]++;
+        cantidad++;
+        return b;
+    }
+
+    // Quita el bloque de las dos listas y devuelve su casilla a la lista libre.
+    // Si el dueo ya no existe, su ranura (quizs reusada) no se toca.
+    void desapilar(int b) {
+        BloqueSoA& n = bloques[b];
+        if (n.anterior != -1) bloques[n.anterior].siguiente = n.siguiente;
+        else tope = n.siguiente;
+        if (n.siguiente != -1) bloques[n.siguiente].anterior = n.anterior;
+
+        bool vivo = tabla->valido(n.proceso);
+        if (n.antDelProceso != -1) bloques[n.antDelProceso].sigDelProceso = n.sigDelProceso;
+        else if (vivo) tabla->primerBloque[n.proceso.ranura] = n.sigDelProceso;
+        if (n.sigDelProceso != -1) bloques[n.sigDelProceso].antDelProceso = n.antDelProceso;
+        if (vivo) tabla->bloquesMemoria[n.proceso.ranura]--;
+
+        n.siguiente = libre;
+        libre = b;
+        cantidad--;
+    }
+
+    // Libera todos los bloques de un proceso (O(k)). Retorna cuntos eran.
+    int liberarDelProceso(unsigned ranura) {
+        int liberados = 0;
+        while (tabla->primerBloque[ranura] != -1) {
+            desapilar(tabla->primerBloque[ranura]);
+            liberados++;
+        }
+        return liberados;
+    }
+};
+
+// Las tres estructuras del motor SoA, ya enlazadas entre s
+struct MotorSoA {
+    TablaNombres nombres;
+    TablaProcesosSoA tabla;
+    ColaSoA cola;
+    PilaBloquesSoA pila;
+
+    MotorSoA() {
+        tabla.tablaNombres = &nombres;
+        cola.tabla = &tabla;
+        pila.tabla = &tabla;
+    }
+
+    void cambiarPrioridad(unsigned ranura, int prioridad) {
+        tabla.fijarPrioridad(ranura, prioridad);
+        if (tabla.posCola[ranura] >= 0) cola.cambiarPrioridad(tabla.posCola[ranura], prioridad);
+    }
+
+    // Saca al proceso de la cola y de la pila y lo borra de la tabla
+    void borrar(unsigned ranura) {
+        pila.liberarDelProceso(ranura);
+        if (tabla.posCola[ranura] >= 0) cola.quitarEn(tabla.posCola[ranura]);
+        tabla.borrar(ranura);
+    }
+};
+
+#endif